@@ -0,0 +1,225 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+// Counts the heap allocations made while the renderer draws a frame.
+// Once the first frames have grown the sprite batch's storage, a
+// frame of sprites, a SpriteStore and text should not allocate at
+// all. Every allocation goes through the replacement operator new
+// below, so the count includes those the standard library makes on
+// the engine's behalf. Needs a window, so it is not registered as a
+// test.
+
+#include "BenchGame.hpp"
+#include <Engine/Font.hpp>
+#include <Engine/Sprite.hpp>
+#include <Engine/SpriteStore.hpp>
+#include <Engine/Text.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace
+{
+  std::atomic<bool> counting{ false };
+  std::atomic<std::size_t> allocations{ 0 };
+
+  void* allocate(std::size_t size)
+  {
+    if (counting.load(std::memory_order_relaxed))
+    {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return std::malloc(size == 0 ? 1 : size);
+  }
+
+  void* allocateAligned(std::size_t size, std::align_val_t alignment)
+  {
+    if (counting.load(std::memory_order_relaxed))
+    {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const auto align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc needs the size to be a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+  }
+
+  void releaseAligned(void* ptr) noexcept
+  {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+  }
+}  // namespace
+
+// the array and nothrow forms forward to these
+void* operator new(std::size_t size)
+{
+  if (auto* ptr = allocate(size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (auto* ptr = allocateAligned(size, alignment))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*alignment*/) noexcept
+{
+  releaseAligned(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+  releaseAligned(ptr);
+}
+
+namespace
+{
+  constexpr std::size_t SPRITE_COUNT = 20000;
+  constexpr int CHECKED_FRAMES       = 60;
+
+  /**
+   * Renders a frame, counting the allocations from preRender to
+   * postRender. Presenting the frame is left out, as the driver's
+   * allocations are outside the engine's control.
+   *
+   * @return The number of allocations made.
+   */
+  template <typename Fn>
+  std::size_t countFrame(ASGE::Renderer& gfx, Fn&& draw)
+  {
+    allocations = 0;
+    counting    = true;
+    gfx.preRender();
+    draw();
+    gfx.postRender();
+    counting = false;
+
+    gfx.swapBuffers();
+    return allocations;
+  }
+}  // namespace
+
+int main()
+{
+  bench::BenchGame game{ "ASGE Allocation Check" };
+  if (!game.ready())
+  {
+    std::printf("FAILED: could not create an OpenGL renderer\n");
+    return EXIT_FAILURE;
+  }
+
+  auto& gfx     = game.gfx();
+  auto* texture = game.whiteTexture();
+
+  auto sprites = gfx.createUniqueSprites(SPRITE_COUNT);
+  std::vector<const ASGE::Sprite*> views;
+  views.reserve(SPRITE_COUNT);
+  for (std::size_t i = 0; i < SPRITE_COUNT; ++i)
+  {
+    auto& sprite = *sprites[i];
+    sprite.attach(texture);
+    sprite.width(8);
+    sprite.height(8);
+    sprite.xPos(static_cast<float>(i % 160) * 8);
+    sprite.yPos(static_cast<float>(i / 160 % 90) * 8);
+    sprite.rotationInRadians(static_cast<float>(i) * 0.01F);
+    views.push_back(&sprite);
+  }
+
+  ASGE::SpriteStore store;
+  const auto handles = store.create(SPRITE_COUNT, texture);
+  for (std::size_t i = 0; i < SPRITE_COUNT; ++i)
+  {
+    store.setDimensions(handles[i], 4, 4);
+    store.setPosition(handles[i], static_cast<float>(i % 320) * 4, static_cast<float>(i / 320 % 180) * 4);
+  }
+
+  const ASGE::Text text{ gfx.getDefaultFont(), "The quick brown fox jumps over the lazy dog", 32, 64 };
+
+  // alternates everything between two positions
+  int tick  = 0;
+  auto draw = [&]
+  {
+    const auto dx = (tick++ & 1) == 0 ? 1.0F : -1.0F;
+    for (std::size_t i = 0; i < SPRITE_COUNT / 2; ++i)
+    {
+      sprites[i]->xPos(sprites[i]->xPos() + dx);
+      gfx.render(*sprites[i]);
+    }
+    gfx.render(std::span<const ASGE::Sprite* const>{ views }.subspan(SPRITE_COUNT / 2));
+
+    store.translate(dx, 0.0F);
+    gfx.render(store);
+    gfx.render(text);
+  };
+
+  for (int i = 0; i < bench::BenchGame::WARM_FRAMES; ++i)
+  {
+    countFrame(gfx, draw);
+  }
+
+  std::size_t worst     = 0;
+  int allocating_frames = 0;
+  for (int i = 0; i < CHECKED_FRAMES; ++i)
+  {
+    const auto frame_allocations = countFrame(gfx, draw);
+    worst = std::max(worst, frame_allocations);
+    allocating_frames += frame_allocations != 0 ? 1 : 0;
+  }
+
+  std::printf(
+    "%d warm frames of %zu sprites, %zu stored sprites and text\n", CHECKED_FRAMES, SPRITE_COUNT,
+    SPRITE_COUNT);
+  std::printf("  frames that allocated    %d\n", allocating_frames);
+  std::printf("  most in one frame        %zu\n", worst);
+  std::printf("  batch allocations, last  %u\n", gfx.renderStats().batch_allocations);
+
+  if (allocating_frames != 0)
+  {
+    std::printf("FAILED: warm frames should not allocate\n");
+    return EXIT_FAILURE;
+  }
+
+  std::printf("no allocations once warm\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "BenchGame.hpp"
+#include <array>
+#include <cstdint>
+
+bench::BenchGame::BenchGame(const std::string& title) : OGLGame(settings(title))
+{
+}
+
+ASGE::GameSettings bench::BenchGame::settings(const std::string& title)
+{
+  ASGE::GameSettings game_settings;
+  game_settings.game_title    = title;
+  game_settings.window_width  = 1280;
+  game_settings.window_height = 720;
+  game_settings.msaa_level    = 1;
+  game_settings.vsync         = ASGE::GameSettings::Vsync::DISABLED;
+  game_settings.mode          = ASGE::GameSettings::WindowMode::WINDOWED;
+  return game_settings;
+}
+
+bool bench::BenchGame::ready() const noexcept
+{
+  return inputs != nullptr;
+}
+
+ASGE::Renderer& bench::BenchGame::gfx() const noexcept
+{
+  return *renderer;
+}
+
+ASGE::Texture2D* bench::BenchGame::whiteTexture()
+{
+  if (white_texture == nullptr)
+  {
+    std::array<std::uint8_t, 2 * 2 * 4> pixels{};
+    pixels.fill(0xFF);
+    white_texture =
+      renderer->createCachedTexture("bench_white", 2, 2, ASGE::Texture2D::RGBA, pixels.data());
+  }
+
+  return white_texture;
+}
+
+void bench::BenchGame::update(const ASGE::GameTime& /*us*/)
+{
+}
+
+void bench::BenchGame::render(const ASGE::GameTime& /*us*/)
+{
+}
@@ -0,0 +1,107 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#ifndef ASGE_BENCHGAME_HPP
+#define ASGE_BENCHGAME_HPP
+
+#include <Engine/OGLGame.hpp>
+#include <Engine/Renderer.hpp>
+#include <chrono>
+#include <string>
+
+namespace bench
+{
+  /**
+   * A game the benchmarks drive one frame at a time, instead of
+   * handing control to Game::run, so each frame's work can be timed.
+   * The window is created without vsync or MSAA so neither skews the
+   * measurements.
+   */
+  class BenchGame : public ASGE::OGLGame
+  {
+   public:
+    explicit BenchGame(const std::string& title);
+
+    /**
+     * Checks the renderer was created.
+     * @return True if the GL context and renderer are usable.
+     */
+    [[nodiscard]] bool ready() const noexcept;
+
+    /**
+     * The game's renderer.
+     * @return The renderer to submit work to.
+     */
+    [[nodiscard]] ASGE::Renderer& gfx() const noexcept;
+
+    /**
+     * A small white texture, created on first use.
+     * @return The texture, owned by the renderer's cache.
+     */
+    [[nodiscard]] ASGE::Texture2D* whiteTexture();
+
+    /**
+     * Renders a frame and presents it.
+     * @param draw Submits the frame's work to the renderer.
+     * @return The CPU time from preRender to postRender, in ms.
+     */
+    template <typename Fn>
+    double frame(Fn&& draw)
+    {
+      using clock      = std::chrono::steady_clock;
+      const auto start = clock::now();
+      renderer->preRender();
+      draw();
+      renderer->postRender();
+      const std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+
+      renderer->swapBuffers();
+      return elapsed.count();
+    }
+
+    /**
+     * Renders a number of frames, discarding the first few while the
+     * renderer's buffers grow to fit.
+     * @param draw Submits each frame's work to the renderer.
+     * @return The mean CPU time of the measured frames, in ms.
+     */
+    template <typename Fn>
+    double measure(Fn&& draw)
+    {
+      for (int i = 0; i < WARM_FRAMES; ++i)
+      {
+        frame(draw);
+      }
+
+      double total = 0;
+      for (int i = 0; i < MEASURED_FRAMES; ++i)
+      {
+        total += frame(draw);
+      }
+
+      return total / MEASURED_FRAMES;
+    }
+
+    void update(const ASGE::GameTime& us) override;
+    void render(const ASGE::GameTime& us) override;
+
+    static constexpr int WARM_FRAMES     = 30;
+    static constexpr int MEASURED_FRAMES = 200;
+
+   private:
+    static ASGE::GameSettings settings(const std::string& title);
+    ASGE::Texture2D* white_texture = nullptr;
+  };
+}  // namespace bench
+
+#endif // ASGE_BENCHGAME_HPP
@@ -0,0 +1,175 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+// Checks that transformQuads writes the same bits as transformQuad
+// for random blocks of quads, then times the two against each other.
+// Exits with a failure if any quad differs, so it doubles as a test.
+
+#include "OpenGL/GLQuadTransform.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+  constexpr std::size_t BLOCK_COUNT = 1U << 15U;
+  constexpr int REPETITIONS         = 20;
+
+  struct BenchBlock
+  {
+    ASGE::QuadBlock block{};
+    std::size_t count = 0;
+  };
+
+  std::vector<BenchBlock> randomBlocks(std::mt19937& rng)
+  {
+    std::uniform_real_distribution<float> position(-2000.0F, 2000.0F);
+    std::uniform_real_distribution<float> size(0.5F, 512.0F);
+    std::uniform_real_distribution<float> angle(-12.6F, 12.6F);
+    std::uniform_real_distribution<float> texels(-256.0F, 1024.0F);
+    std::uniform_real_distribution<float> page(1.0F, 4096.0F);
+    std::uniform_int_distribution<std::size_t> lanes(1, ASGE::QuadBlock::LANES);
+
+    std::vector<BenchBlock> blocks(BLOCK_COUNT);
+    for (auto& bench : blocks)
+    {
+      // most blocks are full, the rest cover the partial tails
+      bench.count = rng() % 4 == 0 ? lanes(rng) : ASGE::QuadBlock::LANES;
+      for (std::size_t lane = 0; lane < bench.count; ++lane)
+      {
+        const float src_rect[4] = { texels(rng), texels(rng), size(rng), size(rng) };
+        ASGE::UvMapping mapping{ texels(rng), texels(rng), 1.0F / page(rng), 1.0F / page(rng) };
+
+        // most sprites are not rotated at all
+        const auto rotation = rng() % 4 == 0 ? 0.0F : angle(rng);
+        bench.block.set(
+          lane, position(rng), position(rng), size(rng), size(rng), rotation, src_rect, mapping);
+      }
+    }
+
+    return blocks;
+  }
+
+  void runScalar(const std::vector<BenchBlock>& blocks, std::vector<ASGE::GPUQuad>& quads)
+  {
+    auto* quad = quads.data();
+    for (const auto& bench : blocks)
+    {
+      const auto& block = bench.block;
+      for (std::size_t lane = 0; lane < bench.count; ++lane)
+      {
+        const float src_rect[4] = {
+          block.src_x[lane], block.src_y[lane], block.src_width[lane], block.src_height[lane]
+        };
+        const ASGE::UvMapping mapping{
+          block.offset_x[lane], block.offset_y[lane], block.inv_width[lane], block.inv_height[lane]
+        };
+        ASGE::transformQuad(
+          block.x[lane], block.y[lane], block.width[lane], block.height[lane], block.rotation[lane],
+          src_rect, mapping, *quad++);
+      }
+    }
+  }
+
+  void runBlocks(const std::vector<BenchBlock>& blocks, std::vector<ASGE::GPUQuad>& quads)
+  {
+    auto* quad = quads.data();
+    std::array<ASGE::GPUQuad*, ASGE::QuadBlock::LANES> lanes{};
+    for (const auto& bench : blocks)
+    {
+      for (std::size_t lane = 0; lane < bench.count; ++lane)
+      {
+        lanes[lane] = quad++;
+      }
+      ASGE::transformQuads(bench.block, bench.count, lanes.data());
+    }
+  }
+
+  template <typename Fn>
+  double bestOf(Fn&& run)
+  {
+    using clock = std::chrono::steady_clock;
+    auto best   = std::chrono::duration<double, std::milli>::max();
+    for (int i = 0; i < REPETITIONS; ++i)
+    {
+      const auto start = clock::now();
+      run();
+      best = std::min<std::chrono::duration<double, std::milli>>(best, clock::now() - start);
+    }
+
+    return best.count();
+  }
+
+  bool sameBits(const ASGE::GPUQuad& lhs, const ASGE::GPUQuad& rhs)
+  {
+    return std::memcmp(&lhs.transform, &rhs.transform, sizeof(lhs.transform)) == 0 &&
+           std::memcmp(&lhs.uv_rect, &rhs.uv_rect, sizeof(lhs.uv_rect)) == 0 &&
+           std::memcmp(&lhs.translation, &rhs.translation, sizeof(lhs.translation)) == 0;
+  }
+}  // namespace
+
+int main()
+{
+  std::mt19937 rng{ 0xA5E5EEDU };
+  const auto blocks = randomBlocks(rng);
+
+  std::size_t quad_count = 0;
+  for (const auto& bench : blocks)
+  {
+    quad_count += bench.count;
+  }
+
+  std::vector<ASGE::GPUQuad> scalar(quad_count);
+  std::vector<ASGE::GPUQuad> simd(quad_count);
+  runScalar(blocks, scalar);
+  runBlocks(blocks, simd);
+
+  std::size_t mismatches = 0;
+  for (std::size_t i = 0; i < quad_count; ++i)
+  {
+    if (!sameBits(scalar[i], simd[i]))
+    {
+      if (mismatches++ < 8)
+      {
+        std::printf(
+          "quad %zu differs: transform (%a %a %a %a) vs (%a %a %a %a)\n", i,
+          static_cast<double>(scalar[i].transform.x), static_cast<double>(scalar[i].transform.y),
+          static_cast<double>(scalar[i].transform.z), static_cast<double>(scalar[i].transform.w),
+          static_cast<double>(simd[i].transform.x), static_cast<double>(simd[i].transform.y),
+          static_cast<double>(simd[i].transform.z), static_cast<double>(simd[i].transform.w));
+      }
+    }
+  }
+
+  const auto scalar_ms = bestOf([&] { runScalar(blocks, scalar); });
+  const auto simd_ms   = bestOf([&] { runBlocks(blocks, simd); });
+
+  std::printf("%zu quads in %zu blocks, best of %d runs\n", quad_count, blocks.size(), REPETITIONS);
+  std::printf("  transformQuad  %8.3f ms  %6.2f ns/quad\n", scalar_ms, scalar_ms * 1e6 / static_cast<double>(quad_count));
+  std::printf("  transformQuads %8.3f ms  %6.2f ns/quad\n", simd_ms, simd_ms * 1e6 / static_cast<double>(quad_count));
+  std::printf("  speedup        %8.2fx\n", scalar_ms / simd_ms);
+
+  if (mismatches != 0)
+  {
+    std::printf("FAILED: %zu of %zu quads differ\n", mismatches, quad_count);
+    return EXIT_FAILURE;
+  }
+
+  std::printf("all quads bit identical\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,268 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+// Times the renderer's CPU cost per frame for the same scene drawn
+// through different paths. Needs a window and an OpenGL context, so
+// it is not registered as a test.
+
+#include "BenchGame.hpp"
+#include "OpenGL/GLLegacySpriteRenderer.hpp"
+#include "OpenGL/GLRenderState.hpp"
+#include "OpenGL/GLTexture.hpp"
+#include "UboSpriteRenderer.hpp"
+#include <Engine/Sprite.hpp>
+#include <Engine/SpriteStore.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+  constexpr std::size_t SPRITE_COUNT = 50000;
+  constexpr float SPRITE_SIZE        = 8.0F;
+  constexpr std::size_t STREAM_QUADS = 100000;
+  constexpr GLuint STREAM_BATCH_SIZE = 500; // quads between texture changes
+
+  struct Placement
+  {
+    float x        = 0;
+    float y        = 0;
+    float rotation = 0;
+  };
+
+  std::vector<Placement> randomPlacements(std::size_t count, float width, float height)
+  {
+    std::mt19937 rng{ 0xA5E5EEDU };
+    std::uniform_real_distribution<float> xs(0.0F, width - SPRITE_SIZE);
+    std::uniform_real_distribution<float> ys(0.0F, height - SPRITE_SIZE);
+    std::uniform_real_distribution<float> angles(0.0F, 6.2831853F);
+
+    std::vector<Placement> placements(count);
+    for (auto& placement : placements)
+    {
+      placement = { xs(rng), ys(rng), angles(rng) };
+    }
+
+    return placements;
+  }
+
+  void report(const char* path, double ms, double baseline_ms)
+  {
+    std::printf("  %-32s %8.3f ms/frame  %6.2fx\n", path, ms, baseline_ms / ms);
+  }
+
+  /**
+   * Moves and draws the same sprites as Sprite objects and as a
+   * SpriteStore. Every sprite is nudged each frame, so both the
+   * per-object updates and the store's bulk update are measured.
+   */
+  void benchSpriteStore(bench::BenchGame& game)
+  {
+    auto& gfx             = game.gfx();
+    auto* texture         = game.whiteTexture();
+    const auto placements = randomPlacements(
+      SPRITE_COUNT, static_cast<float>(gfx.windowWidth()), static_cast<float>(gfx.windowHeight()));
+
+    auto sprites = gfx.createUniqueSprites(SPRITE_COUNT);
+    std::vector<const ASGE::Sprite*> views;
+    views.reserve(SPRITE_COUNT);
+    for (std::size_t i = 0; i < SPRITE_COUNT; ++i)
+    {
+      auto& sprite = *sprites[i];
+      sprite.attach(texture);
+      sprite.width(SPRITE_SIZE);
+      sprite.height(SPRITE_SIZE);
+      sprite.xPos(placements[i].x);
+      sprite.yPos(placements[i].y);
+      sprite.rotationInRadians(placements[i].rotation);
+      views.push_back(&sprite);
+    }
+
+    ASGE::SpriteStore store;
+    const auto handles = store.create(SPRITE_COUNT, texture);
+    for (std::size_t i = 0; i < SPRITE_COUNT; ++i)
+    {
+      store.setDimensions(handles[i], SPRITE_SIZE, SPRITE_SIZE);
+      store.setPosition(handles[i], placements[i].x, placements[i].y);
+      store.setRotation(handles[i], placements[i].rotation);
+    }
+
+    // alternates the sprites between two positions
+    int tick         = 0;
+    const auto nudge = [&tick] { return (tick++ & 1) == 0 ? 1.0F : -1.0F; };
+
+    const auto per_call = game.measure(
+      [&]
+      {
+        const auto dx = nudge();
+        for (const auto& sprite : sprites)
+        {
+          sprite->xPos(sprite->xPos() + dx);
+          gfx.render(*sprite);
+        }
+      });
+
+    const auto spans = game.measure(
+      [&]
+      {
+        const auto dx = nudge();
+        for (const auto& sprite : sprites)
+        {
+          sprite->xPos(sprite->xPos() + dx);
+        }
+        gfx.render(std::span<const ASGE::Sprite* const>{ views });
+      });
+
+    const auto stored = game.measure(
+      [&]
+      {
+        store.translate(nudge(), 0.0F);
+        gfx.render(store);
+      });
+
+    std::printf("%zu moving sprites, mean of %d frames\n", SPRITE_COUNT, bench::BenchGame::MEASURED_FRAMES);
+    report("Sprite, one render call each", per_call, per_call);
+    report("Sprite, rendered as a span", spans, per_call);
+    report("SpriteStore", stored, per_call);
+  }
+  /**
+   * Splits an uploaded range into batches, ending one every
+   * STREAM_BATCH_SIZE quads as a texture change would.
+   *
+   * @param quads The quads being streamed.
+   * @param range The first and last quad of the upload.
+   * @param templ The batch to copy the shader, textures and state from.
+   * @return The batches, offset from the start of the upload.
+   */
+  ASGE::RenderBatches streamBatches(
+    const ASGE::QuadList& quads, const ASGE::QuadRange& range, const ASGE::AnotherRenderBatch& templ)
+  {
+    const auto first = static_cast<GLuint>(std::distance(quads.cbegin(), range.begin));
+    const auto count = static_cast<GLuint>(std::distance(range.begin, range.end)) + 1;
+
+    ASGE::RenderBatches batches;
+    for (GLuint offset = 0; offset < count;)
+    {
+      auto& batch          = batches.emplace_back(templ);
+      batch.start_idx      = offset;
+      batch.instance_count = std::min(count - offset, STREAM_BATCH_SIZE - (first + offset) % STREAM_BATCH_SIZE);
+      offset += batch.instance_count;
+    }
+
+    return batches;
+  }
+
+  /**
+   * Streams the same quads through the OpenGL 3.3 renderer's texture
+   * buffer and through the uniform blocks it used before. The quads
+   * are uploaded and drawn the way GLSpriteBatch::renderQuads does,
+   * as many uploads as each renderer's buffers need. Each renderer
+   * is created in turn on the game's context, so this runs last.
+   */
+  void benchQuadStreams(bench::BenchGame& game)
+  {
+    auto& gfx             = game.gfx();
+    const auto width      = static_cast<float>(gfx.windowWidth());
+    const auto height     = static_cast<float>(gfx.windowHeight());
+    const auto placements = randomPlacements(STREAM_QUADS, width, height);
+
+    ASGE::GPUQuadList payloads(STREAM_QUADS);
+    ASGE::QuadList quads(STREAM_QUADS);
+    for (std::size_t i = 0; i < STREAM_QUADS; ++i)
+    {
+      payloads[i].transform   = { SPRITE_SIZE, 0, 0, SPRITE_SIZE };
+      payloads[i].translation = { placements[i].x, placements[i].y };
+      quads[i].payload_idx    = static_cast<GLuint>(i);
+    }
+
+    ASGE::RenderState state{};
+    state.viewport   = { 0, 0, gfx.windowWidth(), gfx.windowHeight() };
+    state.projection = glm::ortho(0.0F, width, height, 0.0F, -32768.0F, 32767.0F);
+
+    const auto* texture = static_cast<const ASGE::GLTexture*>(game.whiteTexture());
+    ASGE::AnotherRenderBatch templ{};
+    templ.textures.ids[0] = texture->getID();
+    templ.textures.count  = 1;
+    templ.state           = &state;
+
+    int draw_count  = 0;
+    auto stream_all = [&](ASGE::CGLSpriteRenderer& sprite_renderer)
+    {
+      sprite_renderer.setQuadBudget(static_cast<GLuint>(STREAM_QUADS));
+      if (!sprite_renderer.init())
+      {
+        std::printf("FAILED: could not initialise a sprite renderer\n");
+        std::exit(EXIT_FAILURE);
+      }
+
+      templ.shader_id = sprite_renderer.getBasicSpriteShaderID();
+      return game.measure(
+        [&]
+        {
+          draw_count = 0;
+          sprite_renderer.clearActiveRenderState();
+
+          ASGE::QuadRange upload_range{ quads.cbegin(), std::prev(quads.cend()) };
+          while (upload_range.begin != quads.cend())
+          {
+            const auto last_uploaded_quad = sprite_renderer.upload(upload_range, payloads);
+            draw_count += sprite_renderer.render(
+              streamBatches(quads, { upload_range.begin, last_uploaded_quad }, templ));
+            upload_range.begin = std::next(last_uploaded_quad);
+          }
+        });
+    };
+
+    double ubo_ms = 0;
+    int ubo_draws = 0;
+    {
+      bench::UboSpriteRenderer ubo_renderer;
+      ubo_ms    = stream_all(ubo_renderer);
+      ubo_draws = draw_count;
+    }
+
+    double tbo_ms = 0;
+    int tbo_draws = 0;
+    {
+      ASGE::GLLegacySpriteRenderer tbo_renderer;
+      tbo_ms    = stream_all(tbo_renderer);
+      tbo_draws = draw_count;
+    }
+
+    std::printf(
+      "%zu streamed quads, a texture change every %u, mean of %d frames\n", STREAM_QUADS,
+      STREAM_BATCH_SIZE, bench::BenchGame::MEASURED_FRAMES);
+    report("GL 3.3, uniform blocks", ubo_ms, ubo_ms);
+    std::printf("  %-32s %8d draws\n", "", ubo_draws);
+    report("GL 3.3, texture buffer", tbo_ms, ubo_ms);
+    std::printf("  %-32s %8d draws\n", "", tbo_draws);
+  }
+}  // namespace
+
+int main()
+{
+  bench::BenchGame game{ "ASGE Renderer Benchmarks" };
+  if (!game.ready())
+  {
+    std::printf("FAILED: could not create an OpenGL renderer\n");
+    return EXIT_FAILURE;
+  }
+
+  benchSpriteStore(game);
+  benchQuadStreams(game);
+  return EXIT_SUCCESS;
+}
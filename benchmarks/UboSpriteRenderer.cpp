@@ -0,0 +1,227 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "UboSpriteRenderer.hpp"
+#include "OpenGL/Shaders/GLShaders.fs"
+#include <cstring>
+#include <string>
+
+namespace
+{
+  const std::string vs_instancing_ubo =
+  R"(
+  #version 330 core
+
+  #define MAX_NUM_TOTAL_QUADS     1333
+  struct Quad {
+      vec4 transform;      //     16B
+      vec4 uv_rect;        //    +16B
+      vec2 translation;    //     +8B
+      uint colour;         //     +4B
+      uint depth_slot;     //     +4B
+                           // =======
+                           //     48B
+  };
+
+  uniform int quad_buffer_offset;
+
+  layout (std140) uniform global_shader_data
+  {
+      mat4 projection;
+  };
+
+  layout (std140) uniform render_quads
+  {
+      Quad quads[MAX_NUM_TOTAL_QUADS];
+  };
+
+  out VertexData
+  {
+      vec2    uvs;
+      vec4    rgba;
+  }  vs_out;
+
+  // Which of the batch's textures to sample from
+  flat out uint texture_slot;
+
+  // The quad's corners, indexed by gl_VertexID
+  const vec2 corners[4] = vec2[4](vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0));
+
+  vec4 unpackColour(uint rgba)
+  {
+      return vec4((uvec4(rgba) >> uvec4(0u, 8u, 16u, 24u)) & 0xFFu) / 255.0;
+  }
+
+  // The z-order is a signed short packed in the low half
+  float unpackDepth(uint depth_slot)
+  {
+      return float(int(depth_slot << 16u) >> 16);
+  }
+
+  void main()
+  {
+    // Calculate the offset into the UBO
+    int instance_offset = gl_InstanceID + quad_buffer_offset;
+    vec2 corner = corners[gl_VertexID];
+
+    // Final position
+    vec4 transform = quads[instance_offset].transform;
+    vec2 world     = mat2(transform.xy, transform.zw) * corner + quads[instance_offset].translation;
+    gl_Position    = projection * vec4(world, unpackDepth(quads[instance_offset].depth_slot), 1.0);
+    texture_slot   = quads[instance_offset].depth_slot >> 16u;
+
+    // Pass the per-instance color through to the fragment shader.
+    vs_out.rgba = unpackColour(quads[instance_offset].colour);
+
+    // Pass on the texture coordinate mappings
+    vs_out.uvs = mix(quads[instance_offset].uv_rect.xy, quads[instance_offset].uv_rect.zw, corner);
+  }
+  )";
+}  // namespace
+
+bench::UboSpriteRenderer::~UboSpriteRenderer()
+{
+  glDeleteBuffers(BUFFER_COUNT, &UBOs[0]);
+  glDeleteBuffers(1, &indicies_buffer);
+
+  for (GLsync buffer_sync : syncs)
+  {
+    glDeleteSync(buffer_sync);
+  }
+}
+
+bool bench::UboSpriteRenderer::init()
+{
+  auto* sprite_shader = initShader(vs_instancing_ubo, fs_instancing);
+  if (sprite_shader == nullptr)
+  {
+    return false;
+  }
+
+  basic_sprite_shader = sprite_shader->getShaderID();
+  active_shader       = sprite_shader;
+  setupTextureSlots(*sprite_shader);
+  setupGlobalShaderData();
+
+  UBO_buffer_idx = 0;
+  glGenVertexArrays(1, &this->VAO);
+  glBindVertexArray(this->VAO);
+
+  using ASGE::GLRenderConstants::QUAD_INDICIES;
+  glGenBuffers(1, &indicies_buffer);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicies_buffer);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(QUAD_INDICIES), &QUAD_INDICIES[0], GL_STATIC_DRAW);
+
+  auto map_uniform_block = [](GLuint shader_id, const std::string& uniform, GLuint binding)
+  {
+    auto uniform_loc = glGetUniformBlockIndex(shader_id, uniform.c_str());
+    if (uniform_loc != GL_INVALID_INDEX)
+    {
+      glUniformBlockBinding(shader_id, uniform_loc, binding);
+    }
+  };
+
+  map_uniform_block(basic_sprite_shader, "global_shader_data", ASGE::GLRenderConstants::PROJECTION_UBO_BIND);
+  map_uniform_block(basic_sprite_shader, "render_quads", ASGE::GLRenderConstants::QUAD_DATA_UBO_BIND);
+
+  glGenBuffers(BUFFER_COUNT, &UBOs[0]);
+  for (const auto& UBO : UBOs)
+  {
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, UBOSize(), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  }
+
+  ASGE::ClearGLErrors(__PRETTY_FUNCTION__);
+  return true;
+}
+
+int bench::UboSpriteRenderer::render(ASGE::RenderBatches&& batches)
+{
+  glBindBufferRange(
+    GL_UNIFORM_BUFFER, ASGE::GLRenderConstants::QUAD_DATA_UBO_BIND, UBOs[UBO_buffer_idx], 0, UBOSize());
+
+  int draw_count = 0;
+  for (const auto& batch : batches)
+  {
+    apply(batch.state);
+    bindTextures(batch.textures);
+    bindShader(batch.shader_id, static_cast<GLfloat>(batch.distance));
+
+    GLint loc = glGetUniformLocation(active_shader->getShaderID(), "quad_buffer_offset");
+    glUniform1i(loc, static_cast<GLint>(batch.start_idx));
+
+    glDrawElementsInstanced(
+      GL_TRIANGLES,
+      sizeof(ASGE::GLRenderConstants::QUAD_INDICIES),
+      GL_UNSIGNED_BYTE,
+      nullptr,
+      static_cast<GLsizei>(batch.instance_count));
+    ++draw_count;
+  }
+
+  lockBuffer(syncs[UBO_buffer_idx]);
+  UBO_buffer_idx = (UBO_buffer_idx + 1) % BUFFER_COUNT;
+
+  ASGE::ClearGLErrors(__PRETTY_FUNCTION__);
+  return draw_count;
+}
+
+/**
+ *  Retained layers are not part of the comparison.
+ *
+ *  @return No draw calls are issued.
+ */
+int bench::UboSpriteRenderer::render(const ASGE::GLStaticSpriteLayer& /*layer*/, ASGE::RenderState* /*state*/)
+{
+  return 0;
+}
+
+ASGE::QuadIter
+bench::UboSpriteRenderer::upload(const ASGE::QuadRange& range, const ASGE::GPUQuadList& payloads)
+{
+  waitBuffer(syncs[UBO_buffer_idx]);
+  glBindBuffer(GL_UNIFORM_BUFFER, UBOs[UBO_buffer_idx]);
+
+  GLvoid* gpu_mem =
+    glMapBufferRange(GL_UNIFORM_BUFFER, 0, UBOSize(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+  GLuint uploaded = 0;
+  auto cpu_quad   = range.begin;
+
+  do
+  {
+    // the slot is kept with the sort data, as the current renderer expects
+    auto gpu_quad = payloads[cpu_quad->payload_idx];
+    gpu_quad.slot = cpu_quad->slot;
+    std::memcpy(&static_cast<ASGE::GPUQuad*>(gpu_mem)[uploaded++], &gpu_quad, sizeof(ASGE::GPUQuad));
+
+    /// if buffer limit is reached break the loop
+    if (uploaded == QUAD_UBO_LIMIT)
+    {
+      cpu_quad++;
+      break;
+    }
+  } while (cpu_quad++ != range.end);
+
+  glUnmapBuffer(GL_UNIFORM_BUFFER);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  /// return the last quad successfully uploaded
+  return std::prev(cpu_quad);
+}
+
+ASGE::GLRenderer::RenderLib bench::UboSpriteRenderer::getRenderLib() const
+{
+  return ASGE::GLRenderer::RenderLib::GL_LEGACY;
+}
@@ -0,0 +1,55 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#ifndef ASGE_UBOSPRITERENDERER_HPP
+#define ASGE_UBOSPRITERENDERER_HPP
+
+#include "OpenGL/CGLSpriteRenderer.hpp"
+#include <array>
+
+namespace bench
+{
+  /**
+   * The OpenGL 3.3 sprite renderer's upload path from before quads
+   * were streamed through a texture buffer. Each upload waits on one
+   * of three uniform blocks, maps it and copies in at most a block's
+   * worth of quads. The quad offset uniform is looked up for every
+   * batch. Kept only so the benchmarks can compare the two paths.
+   */
+  class UboSpriteRenderer : public ASGE::CGLSpriteRenderer
+  {
+   public:
+    UboSpriteRenderer() = default;
+    ~UboSpriteRenderer() override;
+    UboSpriteRenderer(const UboSpriteRenderer&) = delete;
+    UboSpriteRenderer operator=(const UboSpriteRenderer&) = delete;
+
+    bool init() override;
+    ASGE::QuadIter upload(const ASGE::QuadRange& range, const ASGE::GPUQuadList& payloads) override;
+    int render(ASGE::RenderBatches&& batches) override;
+    int render(const ASGE::GLStaticSpriteLayer& layer, ASGE::RenderState* state) override;
+    [[nodiscard]] ASGE::GLRenderer::RenderLib getRenderLib() const override;
+
+    static constexpr GLuint QUAD_UBO_LIMIT = 1333; // must match MAX_NUM_TOTAL_QUADS
+
+   private:
+    static constexpr GLsizei UBOSize() noexcept { return ASGE::QUAD_STORAGE_SIZE * QUAD_UBO_LIMIT; }
+    static constexpr GLsizei BUFFER_COUNT = 3;
+    std::array<GLuint, BUFFER_COUNT> UBOs{ 0 };
+    std::array<GLsync, BUFFER_COUNT> syncs{ nullptr };
+    GLuint UBO_buffer_idx  = 0;
+    GLuint indicies_buffer = 0;
+  };
+}  // namespace bench
+
+#endif // ASGE_UBOSPRITERENDERER_HPP
@@ -75,6 +75,11 @@ namespace ASGE
     int fps_limit{ 60 }; /**< The engine will attempt to never exceed this tick rate. */     // NOLINT
     int fixed_ts{ fps_limit * 2 }; /**< The delta between fixed time-steps. */               // NOLINT
     int anisotropic{ 16 }; /**< Improves filtering at oblique angles. Not useful for 2D. */  // NOLINT
+    int render_threads{ 0 }; /**< Quad generation workers. Sprites may be changed or destroyed once rendered. */ // NOLINT
+    bool cull_sprites{ false }; /**< Drop sprites outside the camera view before generating their quads. */
+    bool gpu_cull_sprites{ false }; /**< Cull and compact the uploaded quads in a compute pass. OpenGL 4.5 only. */
+    int quad_buffer_budget{ 310000 }; /**< The most quads a frame's streaming buffers may grow to hold. They start small and grow on demand. */ // NOLINT
+    int texture_atlas_threshold{ 0 }; /**< Cached textures no larger than this are packed into shared atlas pages. 0 disables. */ // NOLINT
 
     std::string write_dir{}; /**< The default write directory for ASGE IO. */
     std::string game_title{ "My ASGE Game" }; /**< The window title. */
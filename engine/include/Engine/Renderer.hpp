@@ -22,8 +22,15 @@
 #include "Tile.hpp"
 #include "Viewport.hpp"
 #include "Resolution.hpp"
+#include "SpriteInstance.hpp"
+#include "SpriteStore.hpp"
+#include "StaticSpriteLayer.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace ASGE {
 
@@ -265,6 +272,18 @@ namespace ASGE {
      */
     virtual std::unique_ptr<Sprite> createUniqueSprite() = 0;
 
+    /**
+     *  @brief Creates a number of Sprites using ownership semantics.
+     *
+     *  The memory for all of the sprites is set aside up front and
+     *  recycled once they're destroyed, making this far cheaper than
+     *  creating each sprite in turn.
+     *
+     *  @param count The number of sprites to create.
+     *  @return The uniquely owned sprites.
+     */
+    virtual std::vector<std::unique_ptr<Sprite>> createUniqueSprites(std::size_t count) = 0;
+
     /**
      *  @brief Creates a new Sprite using the heap.
      *
@@ -275,6 +294,17 @@ namespace ASGE {
      */
     virtual Sprite*	createRawSprite() = 0;
 
+    /**
+     *  @brief Creates a new retained sprite layer.
+     *
+     *  Layers keep their sprites' data resident on the GPU, making
+     *  them ideal for large amounts of content that rarely changes.
+     *
+     *  @return A uniquely owned sprite layer.
+     *  @see StaticSpriteLayer
+     */
+    virtual std::unique_ptr<StaticSpriteLayer> createStaticSpriteLayer() = 0;
+
     /**
      *  @brief Renders a sprite to the screen.
      *
@@ -286,12 +316,100 @@ namespace ASGE {
      */
     virtual void render(const ASGE::Sprite& sprite) = 0;
 
+    /**
+     *  @brief Renders a collection of sprites.
+     *
+     *  Equivalent to rendering each sprite in turn, but the per
+     *  sprite overhead is much lower, which makes a difference
+     *  when rendering tens of thousands of sprites a frame.
+     *
+     *  <example>
+     *  @code
+     *    std::vector<const ASGE::Sprite*> visible;
+     *    for (const auto& enemy : enemies)
+     *    {
+     *      visible.push_back(enemy.sprite.get());
+     *    }
+     *    renderer->render(visible);
+     *  @endcode
+     *  </example>
+     *
+     *  @param [in] sprites The sprites to render, all created by this renderer.
+     *  @see Sprite
+     */
+    virtual void render(std::span<const ASGE::Sprite* const> sprites) = 0;
+
+    /**
+     *  @brief Renders an array of raw sprite instances.
+     *
+     *  Each instance is converted directly into GPU data, without
+     *  needing an ASGE::Sprite to be created or updated for it. All
+     *  the instances share a texture, z order and shader, but are
+     *  otherwise sorted and drawn as if they were separate sprites,
+     *  respecting the sort mode and the current render state.
+     *
+     *  @param [in] texture The texture sampled by every instance.
+     *  @param [in] instances The instances to render.
+     *  @param [in] z_order The z ordering to use.
+     *  @param [in] shader The pixel shader to use, or nullptr for the default.
+     *  @see SpriteInstance
+     */
+    virtual void render(
+      const ASGE::Texture2D& texture, std::span<const ASGE::SpriteInstance> instances,
+      int16_t z_order, const SHADER_LIB::Shader* shader = nullptr) = 0;
+
+    /**
+     *  @brief Renders every sprite in a sprite store.
+     *
+     *  The store's arrays are read in order and converted straight
+     *  into GPU data. Each sprite is sorted, culled and drawn as if
+     *  it were a separate Sprite, using the default pixel shader.
+     *
+     *  @param [in] store The sprites to render. Their textures must
+     *  have been created by this renderer.
+     *  @see SpriteStore
+     */
+    virtual void render(const ASGE::SpriteStore& store) = 0;
+
     /**
      * Renders a tile object.
      * @param[in] tile The text object to render.
      */
     virtual void render(const ASGE::Tile& tile, const ASGE::Point2D& xy) = 0;
 
+    /**
+     *  @brief Renders an array of tiles.
+     *
+     *  Each tile is drawn at the position with the same index, and
+     *  is converted straight into GPU data. This is the quickest way
+     *  to draw a large tile map.
+     *
+     *  <example>
+     *  @code
+     *    std::vector<ASGE::Point2D> positions;
+     *    for (int row=0; row < map.rows; ++row) {
+     *      for (int col=0; col < map.cols; ++col) {
+     *        positions.push_back({col * map.tile_width, row * map.tile_height});
+     *      }
+     *    }
+     *
+     *    renderer->render(tiles, positions);
+     *  @endcode
+     *  </example>
+     *
+     *  @param[in] tiles The tiles to render.
+     *  @param[in] positions The xy position of each tile in 2D Space.
+     */
+    virtual void render(std::span<const ASGE::Tile> tiles, std::span<const ASGE::Point2D> positions) = 0;
+
+    /**
+     * Renders a retained sprite layer.
+     * Any dirty sprites in the layer are uploaded before it's drawn.
+     * @param[in] layer The layer to render.
+     * @see StaticSpriteLayer
+     */
+    virtual void render(ASGE::StaticSpriteLayer& layer) = 0;
+
     /**
      * Renders a text object.
      * @param[in] text The text object to render.
@@ -329,7 +447,7 @@ namespace ASGE {
      * extra positional data. For example a tile map can be made up from a list
      * or array of textures. When rendering the absolute position can be
      * forwarded on to the renderer along with the UV mapping and this function
-     * will take care of the rest (it basically maps to a temporary sprite object).
+     * will take care of the rest, without needing a sprite for it.
      *
      * <example>
      * @code
@@ -695,6 +813,31 @@ namespace ASGE {
      */
     [[nodiscard]] ASGE::Texture2D::MagFilter magFilter() const;
 
+    /**
+     * @brief Counters describing how the renderer streamed its last frame.
+     */
+    struct RenderStats
+    {
+      double gpu_stall_ms{ 0 };          /**< Time spent waiting for the GPU to release buffer space. */
+      std::uint32_t gpu_stalls{ 0 };     /**< The number of waits that had to block. */
+      std::size_t bytes_in_flight{ 0 };  /**< Streamed bytes the GPU may still be reading. */
+      std::uint32_t sprites_submitted{ 0 }; /**< Sprites passed to the renderer. */
+      std::uint32_t sprites_culled{ 0 };    /**< Submitted sprites dropped for being outside the view. */
+      std::uint32_t quad_capacity{ 0 };     /**< The quads a frame can stream before the buffers must grow. */
+      std::uint32_t quad_high_water{ 0 };   /**< The most quads streamed in a frame since the buffers were sized. */
+      std::uint32_t gl_calls_avoided{ 0 };  /**< Redundant GL state changes that were skipped. */
+      std::uint32_t batch_allocations{ 0 }; /**< Heap allocations made for the sprite batch's frame storage. Zero once warmed up. */
+    };
+
+    /**
+     * Gets the stats for the last completed frame.
+     * A frame is completed once it's been rendered, so during
+     * rendering these describe the previous frame.
+     *
+     * @return The last frame's render stats.
+     */
+    [[nodiscard]] const RenderStats& renderStats() const noexcept { return render_stats; }
+
 	private:
     GameSettings::WindowMode window_mode{ GameSettings::WindowMode::WINDOWED }; /**< The window mode being used. */
     Colour cls{ COLOURS::STEELBLUE }; /**< The clear colour. Used to blank the window every redraw. */
@@ -714,5 +857,6 @@ namespace ASGE {
     [[nodiscard]] const Colour& defTextColour() const { return default_text_colour; }
 
     ASGE::RenderTarget* active_buffer{ nullptr }; /**< The attached FBO. Used when rendering offscreen to textures. */
+    RenderStats render_stats{}; /**< The stats for the last completed frame. */
 	};
 }  // namespace ASGE
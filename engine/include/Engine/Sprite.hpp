@@ -553,12 +553,40 @@ namespace ASGE
     void setMagFilter(Texture2D::MagFilter requested_filter) const noexcept;
 
    protected:
+    /**
+     * @brief Flags for the values derived from the sprite's transform.
+     *
+     * Any setter that moves, resizes, rotates, scales or flips the
+     * sprite raises every flag. Each cache clears its own flag once
+     * it has been regenerated, so unchanged sprites skip the work.
+     */
+    enum DirtyFlags : uint8_t
+    {
+      BOUNDS_DIRTY = 0x01,                      /**< The world bounds need recalculating. */
+      QUAD_DIRTY   = 0x02,                      /**< The rendered geometry needs regenerating. */
+      ALL_DIRTY    = BOUNDS_DIRTY | QUAD_DIRTY  /**< Everything derived from the transform. */
+    };
+
     /**
      * @brief Retrieves the dimensions.
+     * @note Assumes the caller is resizing the sprite, so marks it dirty.
      * @return The array describing the width and height of the sprite.
      */
     std::array<float, 2>& dimensions();
 
+    /**
+     * @brief Checks whether a cached value is out of date.
+     * @param flag The cache to check.
+     * @return True if the cache needs regenerating.
+     */
+    [[nodiscard]] bool isDirty(DirtyFlags flag) const noexcept;
+
+    /**
+     * @brief Marks a cached value as up to date.
+     * @param flag The cache that was regenerated.
+     */
+    void clearDirty(DirtyFlags flag) const noexcept;
+
    private:
     /**< Sprite Dimensions. The dimensions of the sprite. */
     std::array<float, 2> dims{ 0, 0 };
@@ -574,5 +602,8 @@ namespace ASGE
     FlipFlags flip_flags = NORMAL; /**< Sprite Texture Flip. Flags to control UV mappings.        */
     Colour tint = COLOURS::WHITE; /**< Sprite Colour. Sets the colour of the sprite's vertices.   */
     SHADER_LIB::Shader* shader = nullptr; /**< Sprite Shader. Custom shader to render sprite with.*/
+
+    mutable uint8_t dirty_flags = ALL_DIRTY; /**< Sprite Dirty Flags. The caches needing regeneration. */
+    mutable SpriteBounds world_bounds{};     /**< Sprite World Bounds. Cached by getWorldBounds.      */
   };
 } // namespace ASGE
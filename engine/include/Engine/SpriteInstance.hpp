@@ -0,0 +1,70 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+//! @file SpriteInstance.hpp
+//! @brief
+//! Struct @ref ASGE::SpriteInstance
+
+#ifndef ASGE_SPRITEINSTANCE_HPP
+#define ASGE_SPRITEINSTANCE_HPP
+
+#include "Colours.hpp"
+#include <array>
+
+namespace ASGE
+{
+  /**
+   *  @brief A lightweight record describing a single textured quad.
+   *
+   *  Instances are for games that already keep their positions, sizes
+   *  and colours in their own arrays, such as particle systems or
+   *  simulations. Rather than copying the data into a Sprite each
+   *  frame, a contiguous array of instances that share a texture can
+   *  be handed to the renderer in a single call, which converts them
+   *  straight into GPU quads.
+   *
+   *  Like a Sprite, the position is the top-left of the quad and the
+   *  rotation is applied around its centre. The source rectangle is
+   *  in texels, a negative width or height flips the sampled image.
+   *
+   * Example:
+   * <example>
+   * @code
+   *   std::vector<ASGE::SpriteInstance> sparks(particles.size());
+   *   for (std::size_t i = 0; i < particles.size(); ++i)
+   *   {
+   *     sparks[i].x        = particles[i].x;
+   *     sparks[i].y        = particles[i].y;
+   *     sparks[i].width    = 8;
+   *     sparks[i].height   = 8;
+   *     sparks[i].src_rect = {0, 0, 8, 8};
+   *     sparks[i].opacity  = particles[i].life;
+   *   }
+   *
+   *   renderer->render(*spark_texture, sparks, 10);
+   * @endcode
+   * </example>
+   */
+  struct SpriteInstance
+  {
+    std::array<float, 4> src_rect{ 0, 0, 1, 1 }; /**< Source Rectangle. The region of the texture to sample, in texels. */
+    ASGE::Colour tint{ ASGE::COLOURS::WHITE };   /**< Tint. Used to tint the colour of the quad. */
+    float x{ 0.0F };                             /**< X. The left edge of the quad in world space. */
+    float y{ 0.0F };                             /**< Y. The top edge of the quad in world space. */
+    float width{ 32.0F };                        /**< Width. How wide to render the quad. */
+    float height{ 32.0F };                       /**< Height. How tall to render the quad. */
+    float rotation{ 0.0F };                      /**< Rotation. Rotation to apply in radians. */
+    float opacity{ 1.0F };                       /**< Opacity. Controls the alpha channel i.e. transparency. */
+  };
+}  // namespace ASGE
+
+#endif // ASGE_SPRITEINSTANCE_HPP
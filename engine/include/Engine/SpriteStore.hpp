@@ -0,0 +1,231 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+//! @file SpriteStore.hpp
+//! @brief
+//! Class @ref ASGE::SpriteStore,
+//! Struct @ref ASGE::SpriteHandle
+
+#ifndef ASGE_SPRITESTORE_HPP
+#define ASGE_SPRITESTORE_HPP
+
+#include "Colours.hpp"
+#include "Point2D.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace ASGE
+{
+  class Texture2D;
+
+  /**
+   * @brief A stable reference to a sprite in a SpriteStore.
+   *
+   * Handles remain valid as other sprites are created and destroyed.
+   * Once the sprite itself is destroyed the handle goes stale and is
+   * rejected by the store, even if its slot has since been reused.
+   */
+  struct SpriteHandle
+  {
+    static constexpr std::uint32_t INVALID = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t index      = INVALID; /**< The slot the handle refers to. */
+    std::uint32_t generation = 0;       /**< The slot's generation when the handle was issued. */
+
+    bool operator==(const SpriteHandle&) const = default;
+  };
+
+  /**
+   * @brief Sprites stored as a structure of arrays.
+   *
+   * Every Sprite is its own heap allocation, so rendering tens of
+   * thousands of them touches memory all over the place. A store
+   * instead keeps each property of its sprites in its own contiguous
+   * array, which the renderer walks from start to finish. The store's
+   * sprites have no pixel shader of their own and no flip flags, a
+   * negative source width or height flips the sampled image.
+   *
+   * Sprites are addressed by handle. Destroying a sprite moves the
+   * last sprite into its place, so the arrays stay packed, but the
+   * handles of the other sprites are unaffected.
+   *
+   * <example>
+   * @code
+   *   ASGE::SpriteStore bullets;
+   *   auto handles = bullets.create(1000, bullet_texture);
+   *   bullets.setGlobalZOrders(handles, 5);
+   *
+   *   // every frame
+   *   bullets.setPositions(handles, positions);
+   *   renderer->render(bullets);
+   * @endcode
+   * </example>
+   */
+  class SpriteStore
+  {
+   public:
+    /**
+     * @brief Creates a sprite that renders the whole of a texture.
+     * @param[in] texture The texture to sample, created by the renderer.
+     * @return The new sprite's handle.
+     */
+    SpriteHandle create(Texture2D* texture);
+
+    /**
+     * @brief Creates several identical sprites at once.
+     * @param[in] count The number of sprites to create.
+     * @param[in] texture The texture to sample, created by the renderer.
+     * @return The new sprites' handles.
+     */
+    std::vector<SpriteHandle> create(std::size_t count, Texture2D* texture);
+
+    /**
+     * @brief Destroys a sprite. Stale handles are ignored.
+     * @param[in] handle The sprite to destroy.
+     */
+    void destroy(SpriteHandle handle);
+
+    /**
+     * @brief Destroys several sprites at once.
+     * @param[in] handles The sprites to destroy.
+     */
+    void destroy(std::span<const SpriteHandle> handles);
+
+    /**
+     * @brief Destroys every sprite, invalidating all of the handles.
+     */
+    void clear();
+
+    /**
+     * @brief Reserves space for a number of sprites.
+     * @param[in] count The number of sprites to make room for.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Checks whether a handle still refers to a sprite.
+     * @param[in] handle The handle to check.
+     * @return True if the sprite exists.
+     */
+    [[nodiscard]] bool isValid(SpriteHandle handle) const noexcept;
+
+    /**
+     * @brief Retrieves the number of sprites in the store.
+     * @return The sprite count.
+     */
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    /** @brief Moves a sprite. The position is its top-left corner. */
+    void setPosition(SpriteHandle handle, float x, float y) noexcept;
+    /** @brief Resizes a sprite, before it is scaled. */
+    void setDimensions(SpriteHandle handle, float width, float height) noexcept;
+    /** @brief Rotates a sprite around its centre, in radians. */
+    void setRotation(SpriteHandle handle, float radians) noexcept;
+    /** @brief Scales a sprite equally in both dimensions. */
+    void setScale(SpriteHandle handle, float scale) noexcept;
+    /** @brief Tints a sprite. */
+    void setColour(SpriteHandle handle, Colour colour) noexcept;
+    /** @brief Sets a sprite's opacity. */
+    void setOpacity(SpriteHandle handle, float opacity) noexcept;
+    /** @brief Sets the region of the texture to sample, in texels. */
+    void setSrcRect(SpriteHandle handle, const std::array<float, 4>& rect) noexcept;
+    /** @brief Changes the texture a sprite samples, keeping its source rectangle. */
+    void setTexture(SpriteHandle handle, Texture2D* texture) noexcept;
+    /** @brief Sets the order a sprite is rendered in. */
+    void setGlobalZOrder(SpriteHandle handle, int16_t z_order) noexcept;
+
+    /**
+     * @brief Moves several sprites at once.
+     * @param[in] handles The sprites to move.
+     * @param[in] positions The new positions, one per handle.
+     */
+    void setPositions(std::span<const SpriteHandle> handles, std::span<const Point2D> positions) noexcept;
+
+    /**
+     * @brief Rotates several sprites at once.
+     * @param[in] handles The sprites to rotate.
+     * @param[in] radians The new rotations, one per handle.
+     */
+    void setRotations(std::span<const SpriteHandle> handles, std::span<const float> radians) noexcept;
+
+    /**
+     * @brief Sets the opacity of several sprites at once.
+     * @param[in] handles The sprites to change.
+     * @param[in] opacities The new opacities, one per handle.
+     */
+    void setOpacities(std::span<const SpriteHandle> handles, std::span<const float> opacities) noexcept;
+
+    /**
+     * @brief Sets the render order of several sprites at once.
+     * @param[in] handles The sprites to change.
+     * @param[in] z_order The order to render them all in.
+     */
+    void setGlobalZOrders(std::span<const SpriteHandle> handles, int16_t z_order) noexcept;
+
+    /**
+     * @brief Moves every sprite in the store by the same amount.
+     * @param[in] dx The distance to move along the x axis.
+     * @param[in] dy The distance to move along the y axis.
+     */
+    void translate(float dx, float dy) noexcept;
+
+    /** @brief Retrieves a sprite's position. */
+    [[nodiscard]] Point2D position(SpriteHandle handle) const noexcept;
+    /** @brief Retrieves a sprite's rotation in radians. */
+    [[nodiscard]] float rotation(SpriteHandle handle) const noexcept;
+
+    /**
+     * @brief The packed arrays, in the order the sprites are stored.
+     * Entry i of each array belongs to the same sprite. These are
+     * intended for the renderer and for bulk processing.
+     */
+    [[nodiscard]] std::span<const float> xs() const noexcept { return x; }
+    [[nodiscard]] std::span<const float> ys() const noexcept { return y; }
+    [[nodiscard]] std::span<const float> widths() const noexcept { return width; }
+    [[nodiscard]] std::span<const float> heights() const noexcept { return height; }
+    [[nodiscard]] std::span<const float> rotations() const noexcept { return angle; }
+    [[nodiscard]] std::span<const float> scales() const noexcept { return scale; }
+    [[nodiscard]] std::span<const float> opacities() const noexcept { return alpha; }
+    [[nodiscard]] std::span<const Colour> colours() const noexcept { return tint; }
+    [[nodiscard]] std::span<const std::array<float, 4>> srcRects() const noexcept { return src_rect; }
+    [[nodiscard]] std::span<Texture2D* const> textures() const noexcept { return texture; }
+    [[nodiscard]] std::span<const int16_t> zOrders() const noexcept { return z_order; }
+
+   private:
+    [[nodiscard]] std::size_t denseIndex(SpriteHandle handle) const noexcept;
+
+    // one entry per sprite, packed
+    std::vector<float> x{};
+    std::vector<float> y{};
+    std::vector<float> width{};
+    std::vector<float> height{};
+    std::vector<float> angle{};
+    std::vector<float> scale{};
+    std::vector<float> alpha{};
+    std::vector<Colour> tint{};
+    std::vector<std::array<float, 4>> src_rect{};
+    std::vector<Texture2D*> texture{};
+    std::vector<int16_t> z_order{};
+    std::vector<std::uint32_t> owner{};  // the slot each sprite belongs to
+
+    // one entry per slot, reused once freed
+    std::vector<std::uint32_t> dense{};
+    std::vector<std::uint32_t> generation{};
+    std::vector<std::uint32_t> free_slots{};
+  };
+}  // namespace ASGE
+
+#endif // ASGE_SPRITESTORE_HPP
@@ -0,0 +1,122 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+//! @file StaticSpriteLayer.hpp
+//! @brief Class @ref ASGE::StaticSpriteLayer
+
+#ifndef ASGE_STATICSPRITELAYER_HPP
+#define ASGE_STATICSPRITELAYER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ASGE
+{
+  class Sprite;
+
+  /**
+   * @brief A retained collection of sprites that rarely change.
+   *
+   * Sprites rendered through the renderer have their GPU data
+   * regenerated, sorted and uploaded every frame. For content that
+   * seldom moves, such as backgrounds and level geometry, this is
+   * wasted effort. A static sprite layer instead keeps its sprites'
+   * data resident on the GPU and only re-uploads the sprites that
+   * have been marked as dirty. Rendering the layer is then little
+   * more than a handful of draw calls.
+   *
+   * The layer is drawn in the same pass as the other sprites, using
+   * the layer's global z-order to determine when it's drawn. Within
+   * the layer, sprites are drawn using their own z-orders.
+   *
+   * @warning The layer references the sprites added to it. They must
+   * outlive the layer or the layer must be cleared before they're freed.
+   *
+   * <example>
+   * @code
+   *   auto layer = renderer->createStaticSpriteLayer();
+   *   for (const auto& tile : background_tiles)
+   *   {
+   *     layer->add(*tile);
+   *   }
+   *
+   *   // only needed when one of the sprites is changed
+   *   background_tiles[42]->xPos(100);
+   *   layer->markDirty(42);
+   *
+   *   // every frame
+   *   renderer->render(*layer);
+   * @endcode
+   * </example>
+   */
+  class StaticSpriteLayer
+  {
+   public:
+    StaticSpriteLayer()          = default;
+    virtual ~StaticSpriteLayer() = default;
+
+    StaticSpriteLayer(const StaticSpriteLayer&) = delete;
+    StaticSpriteLayer& operator=(const StaticSpriteLayer&) = delete;
+
+    /**
+     * @brief Adds a sprite to the layer.
+     * @param[in] sprite The sprite to retain.
+     * @return The index of the sprite within the layer.
+     */
+    virtual std::size_t add(const Sprite& sprite) = 0;
+
+    /**
+     * @brief Flags a sprite as changed.
+     *
+     * The sprite's data will be regenerated and uploaded the next
+     * time the layer is rendered.
+     * An index the layer never returned is logged as a warning
+     * and otherwise ignored.
+     *
+     * @param[in] index The index returned when the sprite was added.
+     */
+    virtual void markDirty(std::size_t index) = 0;
+
+    /**
+     * @brief Flags every sprite in the layer as changed.
+     */
+    virtual void markAllDirty() = 0;
+
+    /**
+     * @brief Removes all the sprites from the layer.
+     */
+    virtual void clear() = 0;
+
+    /**
+     * @brief Retrieves the number of sprites in the layer.
+     * @return The sprite count.
+     */
+    [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+
+    /**
+     * @brief Sets the order the layer is rendered in.
+     * @param[in] z_order The layer's global z-order.
+     */
+    void setGlobalZOrder(int16_t z_order) noexcept { global_z_order = z_order; }
+
+    /**
+     * @brief Retrieves the order the layer is rendered in.
+     * @return The layer's global z-order.
+     */
+    [[nodiscard]] int16_t getGlobalZOrder() const noexcept { return global_z_order; }
+
+   private:
+    int16_t global_z_order{ 0 };
+  };
+} // namespace ASGE
+
+#endif // ASGE_STATICSPRITELAYER_HPP
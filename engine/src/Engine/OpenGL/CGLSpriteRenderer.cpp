@@ -11,11 +11,18 @@
 //  SOFTWARE.
 
 #include "CGLSpriteRenderer.hpp"
+#include "GLQuadTransform.hpp"
 #include "GLRenderer.hpp"
+#include "GLStateCache.hpp"
 #include "Logger.hpp"
 #include "OpenGL/GLAtlas.hpp"
 #include "OpenGL/GLFontSet.hpp"
 #include "OpenGL/GLSprite.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <utility>
 
 namespace ASGE
 {
@@ -85,128 +92,153 @@ void ASGE::CGLSpriteRenderer::lockBuffer(GLsync& sync_prim)
   sync_prim = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 }
 
+/**
+ *  Blocks until the GPU has passed a fence.
+ *  An already signalled fence returns straight away. Otherwise the
+ *  command queue is flushed once, so the fence is guaranteed to be
+ *  reached, and the thread sleeps in the driver between checks
+ *  instead of spinning. Any time spent blocked is recorded as a stall.
+ *
+ *  @param sync_prim The fence to wait on.
+ */
 void ASGE::CGLSpriteRenderer::waitBuffer(GLsync& sync_prim)
 {
-  if (sync_prim != nullptr)
+  if (sync_prim == nullptr)
   {
-    while (true)
-    {
-      GLenum wait_sync = glClientWaitSync(sync_prim, GL_SYNC_FLUSH_COMMANDS_BIT, 1);
+    return;
+  }
 
-      if (wait_sync == GL_ALREADY_SIGNALED || wait_sync == GL_CONDITION_SATISFIED)
-      {
-        return;
-      }
-    }
+  auto status = glClientWaitSync(sync_prim, 0, 0);
+  if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+  {
+    return;
   }
-}
 
-bool ASGE::CGLSpriteRenderer::bindTexture(GLuint texture_id)
-{
-  if (current_loaded_texture != texture_id)
+  const auto stall_start = std::chrono::steady_clock::now();
+  GLbitfield flags       = GL_SYNC_FLUSH_COMMANDS_BIT;
+  do
+  {
+    status = glClientWaitSync(sync_prim, flags, GLRenderConstants::FENCE_TIMEOUT_NS);
+    flags  = 0;
+  } while (status == GL_TIMEOUT_EXPIRED);
+
+  if (status == GL_WAIT_FAILED)
   {
-    glActiveTexture(GL_TEXTURE0);
-    GLVMSG("Binding Texture", glBindTexture, GL_TEXTURE_2D, texture_id);
-    current_loaded_texture = texture_id;
-    return true;
+    Logging::ERRORS("Waiting on a buffer fence failed");
   }
-  return false;
+
+  frame_stats.gpu_stall_ms +=
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stall_start).count();
+  ++frame_stats.gpu_stalls;
 }
 
-unsigned int ASGE::CGLSpriteRenderer::getDefaultTextShaderID() const noexcept
+/**
+ *  Completes the renderer's frame.
+ *  @return The stats collected since the last frame ended.
+ */
+ASGE::Renderer::RenderStats ASGE::CGLSpriteRenderer::endFrame()
 {
-  return basic_text_shader;
+  return std::exchange(frame_stats, {});
 }
 
-ASGE::CGLSpriteRenderer::~CGLSpriteRenderer()
+/**
+ *  Binds a batch's textures to their texture units.
+ *  Slot n is bound to GL_TEXTURE0 + n, skipping any unit that
+ *  already has the right texture. The active unit is left as
+ *  GL_TEXTURE0 for the rest of the engine.
+ *
+ *  @param textures The batch's texture slots.
+ *  @return True if any texture was bound.
+ */
+bool ASGE::CGLSpriteRenderer::bindTextures(const TextureSlots& textures)
 {
-  if (glfwGetCurrentContext() != nullptr)
+  auto& state = GLStateCache::getInstance();
+  bool bound  = false;
+  for (GLuint slot = 0; slot < textures.count; ++slot)
   {
-    glDeleteBuffers(1, &vertex_buffer);
-    glDeleteBuffers(1, &shader_data_location);
+    bound = state.bindTexture(slot, GL_TEXTURE_2D, textures.ids[slot]) || bound;
   }
+
+  state.activeTexture(0);
+  return bound;
 }
 
-void ASGE::CGLSpriteRenderer::generateSpriteMatrixData(
-  const ASGE::GLSprite& sprite, glm::mat4* model_matrix_ptr) const
+/**
+ *  Queries how many textures a batch can use and points the
+ *  shader's sampler array at consecutive texture units.
+ *
+ *  @param shader The basic sprite shader.
+ */
+void ASGE::CGLSpriteRenderer::setupTextureSlots(SHADER_LIB::GLShader& shader)
 {
-  // position * rotation * scale
-  // translation to position, followed by rotation
-  // around the middle of the sprite, finished with
-  // a scale and polish
-
-  glm::mat4& model_matrix = *model_matrix_ptr;
-  model_matrix            = { glm::mat4(1.F) };
-
-  model_matrix = glm::translate(
-    model_matrix,
-    glm::vec3(sprite.xPos(), sprite.yPos(), sprite.getGlobalZOrder()));
-
-  model_matrix = glm::translate(
-    model_matrix,
-    glm::vec3(
-      0.5F * sprite.width() * sprite.scale(),
-      0.5F * sprite.height() * sprite.scale(),
-      0.0F));
-
-  model_matrix = glm::rotate(model_matrix, sprite.rotationInRadians(), glm::vec3{ 0, 0, 1 });
-
-  model_matrix = glm::translate(
-    model_matrix,
-    glm::vec3(
-      -0.5F* sprite.width() * sprite.scale(),
-      -0.5F * sprite.height() * sprite.scale(),
-      0.0F));
-
-  model_matrix = glm::scale(
-    model_matrix,
-    glm::vec3(
-      sprite.width() * sprite.scale(), sprite.height() * sprite.scale(), 1.0F));
+  GLint units = 1;
+  glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units);
+  max_texture_slots = std::clamp<GLuint>(
+    static_cast<GLuint>(units), 1, GLRenderConstants::MAX_TEXTURE_SLOTS);
+
+  std::array<GLint, GLRenderConstants::MAX_TEXTURE_SLOTS> samplers{};
+  std::iota(samplers.begin(), samplers.end(), 0);
+
+  shader.use();
+  auto location = glGetUniformLocation(shader.getShaderID(), "images");
+  glUniform1iv(location, static_cast<GLsizei>(max_texture_slots), samplers.data());
+  ClearGLErrors(__PRETTY_FUNCTION__);
 }
 
-void ASGE::CGLSpriteRenderer::generateColourData(const ASGE::GLSprite& sprite, glm::vec4* rgba) const
+GLuint ASGE::CGLSpriteRenderer::getMaxTextureSlots() const noexcept
 {
-  *rgba = glm::vec4{ sprite.colour().r, sprite.colour().g, sprite.colour().b, sprite.opacity() };
+  return max_texture_slots;
 }
 
-void ASGE::CGLSpriteRenderer::generateUvData(
-  const ASGE::GLSprite& sprite, GLfloat uvs[GLRenderConstants::UVS_PER_QUAD]) const
+unsigned int ASGE::CGLSpriteRenderer::getDefaultTextShaderID() const noexcept
 {
-  auto src_rect = glm::vec4(
-    sprite.srcRect()[0],
-    sprite.srcRect()[1],
-    sprite.srcRect()[2],
-    sprite.srcRect()[3]);
+  return basic_text_shader;
+}
 
-  for (int i = 0; i < GLRenderConstants::UVS_PER_QUAD; i += 4)
+ASGE::CGLSpriteRenderer::~CGLSpriteRenderer()
+{
+  if (glfwGetCurrentContext() != nullptr)
   {
-    auto uv_x = uvs[i];
-    uv_x *= src_rect[2] / sprite.getTexture()->getWidth();
-    uv_x += src_rect[0] / sprite.getTexture()->getWidth();
-
-    uvs[i] = uv_x;
+    glDeleteBuffers(1, &vertex_buffer);
+    glDeleteBuffers(1, &shader_data_location);
   }
+}
 
-  for (int i = 1; i < GLRenderConstants::UVS_PER_QUAD; i += 4)
+/**
+ *  Generates a quad's transform, translation and UVs from a copy of
+ *  a sprite's inputs. Only reads the inputs, so it's safe to call
+ *  from any thread.
+ *
+ *  @param inputs The sprite's geometry inputs.
+ *  @param quad The quad to write to.
+ */
+void ASGE::CGLSpriteRenderer::geometryGen(
+  const GLSprite::GeometryInputs& inputs, ASGE::GPUQuad& quad) const noexcept
+{
+  transformQuad(
+    inputs.x,
+    inputs.y,
+    inputs.width,
+    inputs.height,
+    inputs.rotation,
+    inputs.src_rect.data(),
+    uvMapping(*inputs.texture),
+    quad);
+
+  if (inputs.flip_x)
   {
-    auto uv_y = uvs[i];
-    uv_y *= src_rect[3] / sprite.getTexture()->getHeight();
-    uv_y += src_rect[1] / sprite.getTexture()->getHeight();
-
-    uvs[i] = uv_y;
+    std::swap(quad.uv_rect.x, quad.uv_rect.z);
   }
 
-  if (sprite.isFlippedOnX() || sprite.isFlippedOnXY())
+  if (inputs.flip_y)
   {
-    std::swap(uvs[0], uvs[12]);
-    std::swap(uvs[4], uvs[8]);
+    std::swap(quad.uv_rect.y, quad.uv_rect.w);
   }
+}
 
-  if (sprite.isFlippedOnY() || sprite.isFlippedOnXY())
-  {
-    std::swap(uvs[1], uvs[5]);
-    std::swap(uvs[9], uvs[13]);
-  }
+void ASGE::CGLSpriteRenderer::generateColourData(const ASGE::GLSprite& sprite, GLuint* rgba) const
+{
+  *rgba = packColour(sprite.colour().r, sprite.colour().g, sprite.colour().b, sprite.opacity());
 }
 
 void ASGE::CGLSpriteRenderer::createCharQuad(
@@ -217,25 +249,82 @@ void ASGE::CGLSpriteRenderer::createCharQuad(
   float x_pos    = character.x + ch.Bearing.x * character.scale;
   float y_pos    = character.y - ch.Bearing.y * character.scale;
 
-  // generate the matrix
-  auto& model_matrix = quad.position;
-  model_matrix       = { glm::mat4(1.F) };
-
-  model_matrix = glm::translate(model_matrix, glm::vec3(x_pos, y_pos, 0.0F));
-
+  // characters are never rotated, so only scale and translate
   GLfloat w = ch.Size.x * character.scale;
   GLfloat h = ch.Size.y * character.scale;
 
-  model_matrix = glm::scale(model_matrix, glm::vec3(w, h,1.0F));
+  quad.transform   = glm::vec4{ w, 0.0F, 0.0F, h };
+  quad.translation = glm::vec2{ x_pos, y_pos };
+  quad.z_order     = 0;
 
-  // Calculate texture coords for each character
-  quad.uv_data[0] = glm::vec4{ (float)ch.UV.x, (float)ch.UV.w, GPUQuad::PADDING }; // v1
-  quad.uv_data[1] = glm::vec4{ (float)ch.UV.x, (float)ch.UV.y, GPUQuad::PADDING }; // v2
-  quad.uv_data[2] = glm::vec4{ (float)ch.UV.z, (float)ch.UV.y, GPUQuad::PADDING }; // v3
-  quad.uv_data[3] = glm::vec4{ (float)ch.UV.z, (float)ch.UV.w, GPUQuad::PADDING }; // v4
+  // texture coords for the character
+  quad.uv_rect = glm::vec4{ (float)ch.UV.x, (float)ch.UV.y, (float)ch.UV.z, (float)ch.UV.w };
 
   // generate colour data
-  quad.color = { colour.r, colour.g, colour.b, character.alpha };
+  quad.colour = packColour(colour.r, colour.g, colour.b, character.alpha);
+}
+
+/**
+ *  Exposes the renderer's quad storage to the sprite batch.
+ *  Renderers that map their quad buffer can have the batch write
+ *  quads straight into it, in which case upload only has to pass
+ *  on the sorted order. Other renderers copy the batch's quads.
+ *
+ *  @return The mapped quads, or nullptr if they must be uploaded.
+ */
+ASGE::GPUQuad* ASGE::CGLSpriteRenderer::mappedQuads() noexcept
+{
+  return nullptr;
+}
+
+/**
+ *  Reserves space for the batch to write quads into.
+ *  Only called when mappedQuads is supported.
+ *
+ *  @param count The number of quads to reserve.
+ *  @param drawn Whether every quad reserved so far has been drawn.
+ *  @return The index of the first reserved quad, or nullopt if the
+ *  quads that haven't been drawn yet are in the way.
+ */
+std::optional<GLuint> ASGE::CGLSpriteRenderer::reserveQuads(GLuint /*count*/, bool /*drawn*/)
+{
+  return 0;
+}
+
+/**
+ *  Enables culling the uploaded quads on the GPU.
+ *  Only renderers with compute shader support can do so.
+ *
+ *  @param enabled Whether to cull on the GPU.
+ */
+void ASGE::CGLSpriteRenderer::setGpuCulling(bool enabled)
+{
+  if (enabled)
+  {
+    Logging::INFO("GPU culling requires OpenGL 4.5 and has been disabled");
+  }
+}
+
+/**
+ *  Limits how many quads a frame's buffers may hold.
+ *  Must be set before the renderer is initialised.
+ *
+ *  @param budget The most quads to allocate space for.
+ */
+void ASGE::CGLSpriteRenderer::setQuadBudget(GLuint budget) noexcept
+{
+  quad_budget = budget;
+}
+
+/**
+ *  The number of quads a single flush can hold before the
+ *  sprite batch must flush early.
+ *
+ *  @return The current capacity in quads.
+ */
+GLuint ASGE::CGLSpriteRenderer::quadCapacity() const noexcept
+{
+  return quad_budget;
 }
 
 unsigned int ASGE::CGLSpriteRenderer::getBasicSpriteShaderID() const noexcept
@@ -243,15 +332,31 @@ unsigned int ASGE::CGLSpriteRenderer::getBasicSpriteShaderID() const noexcept
   return basic_sprite_shader;
 }
 
-void ASGE::CGLSpriteRenderer::quadGen(const ASGE::GLSprite& sprite, ASGE::GPUQuad& dest) noexcept
+/**
+ *  Generates a sprite's quad.
+ *  The transform and UVs are reused from the sprite's cache when it
+ *  hasn't changed, and cached when regenerated. The colour and z
+ *  order are cheap, so are always written.
+ *
+ *  @param sprite The sprite to generate.
+ *  @param dest The quad to write to.
+ */
+void ASGE::CGLSpriteRenderer::quadGen(const ASGE::GLSprite& sprite, ASGE::GPUQuad& dest) const noexcept
 {
-  auto* gpu_model_data  = reinterpret_cast<glm::mat4*>(&dest.position);
-  auto* gpu_colour_data = reinterpret_cast<glm::vec4*>(&dest.color);
-  auto* gpu_uv_data     = reinterpret_cast<float*>(&dest.uv_data[0]);
+  if (!sprite.cachedGeometry(dest))
+  {
+    // built locally, as the destination may be mapped and is never read back
+    GPUQuad quad;
+    geometryGen(sprite.geometryInputs(), quad);
+    sprite.cacheGeometry(quad);
+
+    dest.transform   = quad.transform;
+    dest.uv_rect     = quad.uv_rect;
+    dest.translation = quad.translation;
+  }
 
-  generateSpriteMatrixData(sprite, gpu_model_data);
-  generateColourData(sprite, gpu_colour_data);
-  generateUvData(sprite, &gpu_uv_data[0]);
+  generateColourData(sprite, &dest.colour);
+  dest.z_order = sprite.getGlobalZOrder();
 }
 
 void ASGE::CGLSpriteRenderer::setActiveShader(ASGE::SHADER_LIB::GLShader* shader)
@@ -270,30 +375,66 @@ void ASGE::CGLSpriteRenderer::apply(ASGE::RenderState* state)
   {
     if(!active_render_state || active_render_state->projection != state->projection)
     {
-      glBindBuffer(GL_UNIFORM_BUFFER, shader_data_location);
-      glBufferSubData(
-        GL_UNIFORM_BUFFER,
-        0,
-        sizeof(glm::mat4),
-        glm::value_ptr(state->projection));
+      bindProjection(*state);
     }
 
     if(!active_render_state || active_render_state->viewport != state->viewport)
     {
-      auto& vp = state->viewport;
-      glViewport(vp.x, vp.y, vp.w, vp.h);
+      GLStateCache::getInstance().viewport(state->viewport);
     }
     active_render_state = state;
   }
 }
 
+/**
+ *  Binds the state's projection, uploading it if needed.
+ *  Projections are written once into a ring of UBO slots and are
+ *  then bound by offset, so switching back to a state is just a
+ *  rebind. Each time the ring wraps the epoch moves on, which
+ *  invalidates every state's upload as its slot may be rewritten.
+ *
+ *  @param state The state whose projection to bind.
+ */
+void ASGE::CGLSpriteRenderer::bindProjection(RenderState& state)
+{
+  if (state.projection_epoch != projection_epoch)
+  {
+    if (projection_slot == GLRenderConstants::PROJECTION_UBO_SLOTS)
+    {
+      projection_slot = 0;
+      ++projection_epoch;
+    }
+
+    state.projection_offset = static_cast<GLintptr>(projection_slot++) * projection_stride;
+    state.projection_epoch  = projection_epoch;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, shader_data_location);
+    glBufferSubData(
+      GL_UNIFORM_BUFFER, state.projection_offset, sizeof(glm::mat4), glm::value_ptr(state.projection));
+  }
+
+  glBindBufferRange(
+    GL_UNIFORM_BUFFER,
+    GLRenderConstants::PROJECTION_UBO_BIND,
+    shader_data_location,
+    state.projection_offset,
+    sizeof(SHADER_DATA));
+}
+
 void ASGE::CGLSpriteRenderer::setupGlobalShaderData()
 {
+  // each slot of the projection ring starts on an aligned offset
+  GLint alignment = 1;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  projection_stride = std::lcm(static_cast<GLintptr>(sizeof(SHADER_DATA)), std::max<GLintptr>(alignment, 1));
+
   // setup shader data location
   glGenBuffers(1, &shader_data_location);
   glBindBuffer(GL_UNIFORM_BUFFER, shader_data_location);
-  glBufferData(GL_UNIFORM_BUFFER, sizeof(SHADER_DATA), nullptr, GL_DYNAMIC_DRAW);
-  glBindBufferBase(GL_UNIFORM_BUFFER, GLRenderConstants::PROJECTION_UBO_BIND, shader_data_location);
+  glBufferData(
+    GL_UNIFORM_BUFFER, projection_stride * GLRenderConstants::PROJECTION_UBO_SLOTS, nullptr, GL_DYNAMIC_DRAW);
+  glBindBufferRange(
+    GL_UNIFORM_BUFFER, GLRenderConstants::PROJECTION_UBO_BIND, shader_data_location, 0, sizeof(SHADER_DATA));
 }
 
 void ASGE::CGLSpriteRenderer::clearActiveRenderState()
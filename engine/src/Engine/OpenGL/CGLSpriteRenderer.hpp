@@ -17,10 +17,15 @@
 #include "GLRenderBatch.hpp"
 #include "GLRenderer.hpp"
 #include "GLShader.hpp"
+#include "GLSprite.hpp"
+#include <array>
+#include <optional>
 #include <vector>
 
 namespace ASGE
 {
+  class GLStaticSpriteLayer;
+  class GLTexture;
 
   /**
    * The platform specific implementation of an ASGE renderer based
@@ -35,20 +40,29 @@ namespace ASGE
     CGLSpriteRenderer() = default;
     virtual ~CGLSpriteRenderer();
     virtual bool init() = 0;
-    virtual QuadIter upload(const QuadRange& range) = 0;
-    virtual int render(std::vector<AnotherRenderBatch>&& batches) = 0;
+    virtual QuadIter upload(const QuadRange& range, const GPUQuadList& payloads) = 0;
+    virtual int render(RenderBatches&& batches) = 0;
+    virtual int render(const GLStaticSpriteLayer& layer, RenderState* state) = 0;
+    virtual Renderer::RenderStats endFrame();
+    [[nodiscard]] virtual GPUQuad* mappedQuads() noexcept;
+    virtual std::optional<GLuint> reserveQuads(GLuint count, bool drawn);
+    virtual void setGpuCulling(bool enabled);
+    void setQuadBudget(GLuint budget) noexcept;
+    [[nodiscard]] virtual GLuint quadCapacity() const noexcept;
 
     CGLSpriteRenderer(const CGLSpriteRenderer&) = delete;
     CGLSpriteRenderer& operator=(const CGLSpriteRenderer&) = delete;
 
     ASGE::SHADER_LIB::GLShader* initShader(const std::string& vertex_shader, const std::string& fragment_shader);
-    void quadGen(const GLSprite& sprite, GPUQuad& dest) noexcept;
+    void quadGen(const GLSprite& sprite, GPUQuad& dest) const noexcept;
+    void geometryGen(const GLSprite::GeometryInputs& inputs, GPUQuad& quad) const noexcept;
     void createCharQuad( const GLCharRender& character, const ASGE::Colour& colour, ASGE::GPUQuad& quad) const;
     void clearActiveRenderState();
 
     [[nodiscard]] virtual GLRenderer::RenderLib getRenderLib() const = 0;
     [[nodiscard]] unsigned int getDefaultTextShaderID() const noexcept;
     [[nodiscard]] unsigned int getBasicSpriteShaderID() const noexcept;
+    [[nodiscard]] GLuint getMaxTextureSlots() const noexcept;
 
     void setActiveShader(ASGE::SHADER_LIB::GLShader* shader);
     ASGE::SHADER_LIB::GLShader* activeShader();
@@ -58,22 +72,27 @@ namespace ASGE
     GLuint  basic_text_shader = 0;
     GLuint  vertex_buffer = 0;
     GLuint  VAO = 0;
-    GLuint  current_loaded_texture = 0;
+    GLuint  max_texture_slots = 1;
+    GLuint  quad_budget = GLRenderConstants::MAX_BATCH_COUNT;
     GLuint  shader_data_location = 0;
     RenderState* active_render_state {nullptr};
+    GLintptr projection_stride = 0;
+    GLuint  projection_slot    = 0;
+    GLuint  projection_epoch   = 1;
+    Renderer::RenderStats frame_stats {};
     SHADER_LIB::GLShader* active_shader = nullptr;
 
-    void generateSpriteMatrixData(const ASGE::GLSprite& sprite, glm::mat4* model_matrix) const;
-    void generateColourData(const ASGE::GLSprite& sprite, glm::vec4* rgba) const;
-    void generateUvData(const ASGE::GLSprite& sprite, GLfloat[GLRenderConstants::UVS_PER_QUAD]) const;
+    void generateColourData(const ASGE::GLSprite& sprite, GLuint* rgba) const;
     void checkForErrors() const;
     bool bindShader(GLuint shader_id, GLfloat distance) noexcept;
     void lockBuffer(GLsync& sync_prim);
     void waitBuffer(GLsync& sync_prim);
-    bool bindTexture(GLuint texture_id);
+    bool bindTextures(const TextureSlots& textures);
+    void setupTextureSlots(SHADER_LIB::GLShader& shader);
 
     // work in progress
     void apply(ASGE::RenderState* state);
+    void bindProjection(RenderState& state);
     void setupGlobalShaderData();
   };
 
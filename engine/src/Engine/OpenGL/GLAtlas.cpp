@@ -26,6 +26,8 @@ constexpr int TEXTURE_WIDTH = 1024;
 
 // Engine related
 #include "Logger.hpp"
+#include "GLStateCache.hpp"
+#include "GLTexture.hpp"
 #include "Point2D.hpp"
 
 namespace
@@ -55,6 +57,7 @@ ASGE::FontTextureAtlas::~FontTextureAtlas()
 {
   if (glfwGetCurrentContext() != nullptr)
   {
+    GLStateCache::getInstance().forgetTexture(texture);
     glDeleteTextures(1, &texture);
   }
 }
@@ -171,7 +174,6 @@ bool ASGE::FontTextureAtlas::init(
   }
 
   allocateTexture(pixels.data());
-  glBindTexture(GL_TEXTURE_2D, 0);
 
   Logging::DEBUG(std::string("Generated Font Atlas: ").append(face->family_name));
   std::stringstream ss;
@@ -192,16 +194,36 @@ const ASGE::Character& ASGE::FontTextureAtlas::getCharacter(int idx) const
 
 void ASGE::FontTextureAtlas::allocateTexture(const void* data)
 {
+  if (GLTexture::useDSA())
+  {
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, 1, GL_RGBA8, width, height);
+    glTextureSubImage2D(texture, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    setSampleParams();
+    ASGE::ClearGLErrors("Error allocating texture for font atlas");
+    return;
+  }
+
   glGenTextures(1, &texture);
-  glBindTexture(GL_TEXTURE_2D, texture);
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, texture);
   glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
   glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
   setSampleParams();
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, 0);
   ASGE::ClearGLErrors("Error allocating texture for font atlas");
 }
 
 void ASGE::FontTextureAtlas::setSampleParams()
 {
+  if (GLTexture::useDSA())
+  {
+    GLVMSG(__PRETTY_FUNCTION__, glTextureParameteri, texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    GLVMSG(__PRETTY_FUNCTION__, glTextureParameteri, texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLVMSG(__PRETTY_FUNCTION__, glTextureParameteri, texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GLVMSG(__PRETTY_FUNCTION__, glTextureParameteri, texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return;
+  }
+
   GLVMSG(__PRETTY_FUNCTION__, glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   GLVMSG(__PRETTY_FUNCTION__, glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
   GLVMSG(__PRETTY_FUNCTION__, glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -0,0 +1,236 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLComputeCuller.hpp"
+#include "GLConstants.hpp"
+#include "GLQuad.hpp"
+#include "GLStateCache.hpp"
+#include "Logger.hpp"
+#include <OpenGL/Shaders/GLShaders.comp>
+#include <algorithm>
+#include <array>
+
+namespace
+{
+  constexpr GLuint WORKGROUP_SIZE = 256; // must match the compute shaders
+
+  constexpr GLuint GROUP_SSBO_BIND     = 12;
+  constexpr GLuint OFFSET_SSBO_BIND    = 13;
+  constexpr GLuint BLOCK_SSBO_BIND     = 14;
+  constexpr GLuint COMPACTED_SSBO_BIND = 15;
+  constexpr GLuint COMMAND_SSBO_BIND   = 16;
+
+  GLuint workgroups(GLuint count)
+  {
+    return (count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+  }
+}  // namespace
+
+ASGE::GLComputeCuller::~GLComputeCuller()
+{
+  if (glfwGetCurrentContext() != nullptr)
+  {
+    glDeleteBuffers(1, &group_buffer);
+    glDeleteBuffers(1, &offset_buffer);
+    glDeleteBuffers(1, &block_buffer);
+    glDeleteBuffers(1, &compacted_buffer);
+    glDeleteBuffers(1, &command_buffer);
+  }
+}
+
+/**
+ *  Compiles the pass and looks up its counts. Passes that don't use
+ *  a count have it optimised out, leaving its location at -1, which
+ *  GL silently ignores when it's set.
+ *
+ *  @param source The compute shader's source.
+ *  @return True if the pass compiled.
+ */
+bool ASGE::GLComputeCuller::Pass::compile(const std::string& source)
+{
+  if (!shader.compile(GL_COMPUTE_SHADER, source.c_str()))
+  {
+    return false;
+  }
+
+  const auto program = static_cast<GLuint>(shader.getShaderID());
+  instance_count     = glGetUniformLocation(program, "instance_count");
+  group_count        = glGetUniformLocation(program, "group_count");
+  return true;
+}
+
+/**
+ *  Sets the pass's counts and dispatches it.
+ *
+ *  @param instances The number of quads being culled.
+ *  @param groups The number of groups being culled.
+ *  @param workgroup_count The number of workgroups to dispatch.
+ */
+void ASGE::GLComputeCuller::Pass::dispatch(
+  GLuint instances, GLuint groups, GLuint workgroup_count) const
+{
+  const auto program = static_cast<GLuint>(shader.getShaderID());
+  glProgramUniform1ui(program, instance_count, instances);
+  glProgramUniform1ui(program, group_count, groups);
+  GLStateCache::getInstance().useProgram(program);
+  glDispatchCompute(workgroup_count, 1, 1);
+}
+
+/**
+ *  Compiles the compute passes and allocates their buffers.
+ *  Everything but the groups stays on the GPU, so none of the
+ *  buffers are mapped. The passes are then checked against a
+ *  known result, so a driver that compiles them but runs them
+ *  incorrectly, such as an older software rasteriser, is caught
+ *  here and the quads are culled on the CPU instead.
+ *
+ *  @param instance_limit The most quads a single upload can hold.
+ *  @return True if the passes compiled and culled correctly.
+ */
+bool ASGE::GLComputeCuller::init(GLuint instance_limit)
+{
+  if (
+    !test_pass.compile(cs_cull_test) || !scan_pass.compile(cs_cull_scan) ||
+    !compact_pass.compile(cs_cull_compact))
+  {
+    Logging::ERRORS("Failed to compile the culling compute shaders");
+    return false;
+  }
+
+  auto create = [](GLuint& buffer, GLsizeiptr size, GLbitfield flags) {
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, size, nullptr, flags);
+  };
+
+  max_instances             = instance_limit;
+  constexpr auto INDEX_SIZE = static_cast<GLsizeiptr>(sizeof(GLuint));
+  constexpr auto MAX_GROUPS = static_cast<GLsizeiptr>(GLRenderConstants::INDIRECT_COMMAND_LIMIT);
+  const auto instances      = static_cast<GLsizeiptr>(instance_limit);
+  const auto blocks         = static_cast<GLsizeiptr>(workgroups(instance_limit));
+  create(group_buffer, MAX_GROUPS * static_cast<GLsizeiptr>(sizeof(Group)), GL_DYNAMIC_STORAGE_BIT);
+  create(offset_buffer, instances * INDEX_SIZE, 0);
+  create(block_buffer, (blocks + 1) * INDEX_SIZE, 0);
+  create(compacted_buffer, instances * INDEX_SIZE, 0);
+  create(command_buffer, MAX_GROUPS * COMMAND_SIZE, 0);
+
+  ClearGLErrors(__PRETTY_FUNCTION__);
+  if (!verify())
+  {
+    Logging::ERRORS("The culling compute shaders produced incorrect results");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ *  Culls two quads, one inside the view and one outside of it, and
+ *  reads back the results. Only used once the passes are created,
+ *  as it stalls until the GPU has finished. The quad and order
+ *  bindings are replaced, but every upload rebinds them anyway.
+ *
+ *  @return True if only the visible quad survived.
+ */
+bool ASGE::GLComputeCuller::verify()
+{
+  if (max_instances < 2)
+  {
+    return true;
+  }
+
+  std::array<GPUQuad, 2> quads{};
+  quads[0].translation = glm::vec2{ 4, 4 };
+  quads[1].translation = glm::vec2{ 64, 64 };
+  constexpr std::array<GLuint, 2> ORDER{ 1, 0 };
+
+  GLuint quad_buffer  = 0;
+  GLuint order_buffer = 0;
+  glCreateBuffers(1, &quad_buffer);
+  glNamedBufferStorage(quad_buffer, sizeof(quads), quads.data(), 0);
+  glCreateBuffers(1, &order_buffer);
+  glNamedBufferStorage(order_buffer, sizeof(ORDER), ORDER.data(), 0);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GLRenderConstants::QUAD_DATA_SSBO_BIND, quad_buffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GLRenderConstants::QUAD_ORDER_SSBO_BIND, order_buffer);
+
+  std::vector<Group> groups(1);
+  groups[0].view  = glm::vec4{ 0, 16, 0, 16 };
+  groups[0].count = 2;
+
+  std::array<GLuint, COMMAND_SIZE / sizeof(GLuint)> command{};
+  GLuint survivor = 0;
+  if (cull(2, groups))
+  {
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glGetNamedBufferSubData(command_buffer, 0, COMMAND_SIZE, command.data());
+    glGetNamedBufferSubData(compacted_buffer, 0, sizeof(survivor), &survivor);
+  }
+
+  glDeleteBuffers(1, &quad_buffer);
+  glDeleteBuffers(1, &order_buffer);
+  GLStateCache::getInstance().useProgram(0);
+  ClearGLErrors(__PRETTY_FUNCTION__);
+
+  // count, instance count, first index, base vertex, base instance
+  return command[0] == 6 && command[1] == 1 && command[4] == 0 && survivor == 0;
+}
+
+/**
+ *  Culls an upload's quads and writes a draw command per group.
+ *  The quads and their sorted order must already be bound to their
+ *  usual bindings. The program in use is changed, so the caller is
+ *  responsible for restoring it.
+ *
+ *  @param instance_count The number of quads in the upload.
+ *  @param groups The ranges to cull, in ascending order.
+ *  @return False if there was too much to cull.
+ */
+bool ASGE::GLComputeCuller::cull(GLuint instance_count, const std::vector<Group>& groups)
+{
+  if (
+    instance_count == 0 || instance_count > max_instances || groups.empty() ||
+    groups.size() > GLRenderConstants::INDIRECT_COMMAND_LIMIT)
+  {
+    return false;
+  }
+
+  const auto group_count = static_cast<GLuint>(groups.size());
+  glNamedBufferSubData(
+    group_buffer, 0, static_cast<GLsizeiptr>(groups.size() * sizeof(Group)), groups.data());
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GROUP_SSBO_BIND, group_buffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OFFSET_SSBO_BIND, offset_buffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BLOCK_SSBO_BIND, block_buffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMPACTED_SSBO_BIND, compacted_buffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_SSBO_BIND, command_buffer);
+
+  test_pass.dispatch(instance_count, group_count, workgroups(instance_count));
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+  scan_pass.dispatch(instance_count, group_count, 1);
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+  compact_pass.dispatch(instance_count, group_count, workgroups(std::max(instance_count, group_count)));
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+  ClearGLErrors(__PRETTY_FUNCTION__);
+  return true;
+}
+
+/**
+ *  Binds the compacted order in place of the sorted order and the
+ *  draw commands as the indirect buffer. Group n is drawn by the
+ *  command at n * COMMAND_SIZE.
+ */
+void ASGE::GLComputeCuller::bindResults() const
+{
+  glBindBufferBase(
+    GL_SHADER_STORAGE_BUFFER, GLRenderConstants::QUAD_ORDER_SSBO_BIND, compacted_buffer);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+}
@@ -0,0 +1,89 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#ifndef ASGE_GLCOMPUTECULLER_HPP
+#define ASGE_GLCOMPUTECULLER_HPP
+
+#include "GLIncludes.hpp"
+#include "GLShader.hpp"
+#include <string>
+#include <vector>
+
+namespace ASGE
+{
+  /**
+   * Culls streamed quads on the GPU using compute shaders.
+   * The quads of an upload are split into groups, each drawn with
+   * a single command and tested against its own camera view. The
+   * survivors are compacted into a separate order buffer, keeping
+   * their sorted order, and each group's draw command is written
+   * with the number of survivors. The CPU never sees the results,
+   * the groups are drawn with glDrawElementsIndirect.
+   */
+  class GLComputeCuller
+  {
+   public:
+    /**
+     * A contiguous range of an upload's quads, drawn as one command.
+     * Matches the CullGroup struct in the compute shaders.
+     */
+    struct Group
+    {
+      glm::vec4 view{};  // min x, max x, min y, max y
+      GLuint first = 0;
+      GLuint count = 0;
+      GLuint padding[2]{};
+    };
+
+    static constexpr GLuint COMMAND_SIZE = 20; // sizeof(DrawElementsIndirectCommand)
+
+    GLComputeCuller() = default;
+    ~GLComputeCuller();
+
+    GLComputeCuller(const GLComputeCuller&) = delete;
+    GLComputeCuller& operator=(const GLComputeCuller&) = delete;
+
+    bool init(GLuint instance_limit);
+    bool cull(GLuint instance_count, const std::vector<Group>& groups);
+    void bindResults() const;
+
+   private:
+    /**
+     * A compute pass and the locations of its counts, which are
+     * looked up once it compiles rather than on every dispatch.
+     */
+    struct Pass
+    {
+      SHADER_LIB::GLShader shader;
+      GLint instance_count = -1;
+      GLint group_count    = -1;
+
+      bool compile(const std::string& source);
+      void dispatch(GLuint instances, GLuint groups, GLuint workgroup_count) const;
+    };
+
+    bool verify();
+
+    Pass test_pass;
+    Pass scan_pass;
+    Pass compact_pass;
+    GLuint max_instances = 0;
+
+    GLuint group_buffer     = 0;
+    GLuint offset_buffer    = 0;
+    GLuint block_buffer     = 0;
+    GLuint compacted_buffer = 0;
+    GLuint command_buffer   = 0;
+  };
+}  // namespace ASGE
+
+#endif // ASGE_GLCOMPUTECULLER_HPP
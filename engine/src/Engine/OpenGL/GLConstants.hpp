@@ -17,25 +17,24 @@
 namespace ASGE::GLRenderConstants
   {
     static constexpr int MAX_BATCH_COUNT = 310000; // 310689;
-    static constexpr int UVS_PER_QUAD = 16; // 8UVS + 32Bytes padding
     static constexpr int VERTEX_PER_QUAD = 4;
-
-    static constexpr GLsizei UV_STORAGE_SIZE = sizeof(float) * UVS_PER_QUAD * MAX_BATCH_COUNT;
-    static constexpr GLsizei MATRIX_STORAGE_SIZE = sizeof(glm::mat4) * MAX_BATCH_COUNT;
-    static constexpr GLsizei COLOUR_STORAGE_SIZE = sizeof(glm::vec4) * MAX_BATCH_COUNT;
+    static constexpr GLuint MAX_TEXTURE_SLOTS = 16; // must match the sprite fragment shader
 
     static constexpr GLuint PROJECTION_UBO_BIND = 1;
-    static constexpr GLuint OFFSET_UBO_BIND = 2;
+    static constexpr GLuint PROJECTION_UBO_SLOTS = 256; // distinct projections before the ring wraps
+    static constexpr GLuint QUAD_INDEX_ATTRIB = 1;
+    static constexpr GLuint QUAD_ORDER_SSBO_BIND = 11; // the sorted indices into the quad SSBO
+    static constexpr GLuint QUAD_ORDER_SLOT_SHIFT = 28; // each sorted index carries its texture slot above this
+    static constexpr GLuint QUAD_ORDER_INDEX_MASK = (1U << QUAD_ORDER_SLOT_SHIFT) - 1;
+    static_assert(MAX_TEXTURE_SLOTS <= (1U << (32 - QUAD_ORDER_SLOT_SHIFT)), "Texture slots no longer fit in the sorted order");
+    static constexpr GLuint INDIRECT_COMMAND_LIMIT = 65536;
+    static constexpr GLuint64 FENCE_TIMEOUT_NS = 1000000; // 1ms between checks on a blocked fence
 
     /// LEGACY RENDERER
     static constexpr GLuint QUAD_DATA_SSBO_BIND = 10;
-    static constexpr GLuint QUAD_UBO_LIMIT = 400;
+    static constexpr GLuint QUAD_TBO_UNIT = MAX_TEXTURE_SLOTS; // the legacy quad buffer, after the sprite slots
     static constexpr GLuint QUAD_DATA_UBO_BIND = 10;
 
-    static constexpr GLfloat QUAD_VERTICES[] =
-      { 0.0F, 1.0F, 0.0F, 0.0F,
-        1.0F, 0.0F, 1.0F, 1.0F };
-
     static constexpr GLubyte QUAD_INDICIES[] =
       { 0, 1, 2, 0, 2, 3 };
   }  // namespace ASGE::GLRenderConstants
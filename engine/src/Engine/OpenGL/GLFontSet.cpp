@@ -12,6 +12,7 @@
 
 #include "GLFontSet.hpp"
 #include "GLAtlas.hpp"
+#include "GLStateCache.hpp"
 #include "GLTexture.hpp"
 #include <vector>
 
@@ -160,9 +161,16 @@ std::tuple<float, float> ASGE::GLFontSet::boundsY(const std::string& string, flo
 
 void ASGE::GLFontSet::setMagFilter(ASGE::Texture2D::MagFilter mag_filter)
 {
-  if (atlas)
+  if (atlas && GLTexture::useDSA())
   {
-    glBindTexture(GL_TEXTURE_2D, atlas->getTextureID());
+    GLVMSG(
+      __PRETTY_FUNCTION__,
+      glTextureParameteri, atlas->getTextureID(),
+      GL_TEXTURE_MAG_FILTER, GLTexture::GL_MAG_LOOKUP.at(mag_filter));
+  }
+  else if (atlas)
+  {
+    GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, atlas->getTextureID());
     GLVMSG(
       __PRETTY_FUNCTION__,
       glTexParameteri, GL_TEXTURE_2D,
@@ -15,3 +15,8 @@
 constexpr int GLFORMAT[5]{
   GL_R, GL_LUMINANCE, GL_LUMINANCE_ALPHA, GL_RGB, GL_RGBA,
 };
+
+// immutable storage needs a sized internal format
+constexpr int GLSIZEDFORMAT[5]{
+  GL_R8, GL_R8, GL_RG8, GL_RGB8, GL_RGBA8,
+};
@@ -0,0 +1,117 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLFrameArena.hpp"
+#include <algorithm>
+#include <numeric>
+
+/**
+ *  Creates the arena with its first block.
+ *
+ *  @param min_block_size The smallest block the arena will allocate.
+ */
+ASGE::GLFrameArena::GLFrameArena(std::size_t min_block_size) : block_size(min_block_size)
+{
+  blocks.push_back({ std::make_unique<std::byte[]>(min_block_size), min_block_size });
+}
+
+/**
+ *  Releases every allocation made since the last reset.
+ *  Nothing allocated from the arena may be used afterwards. If the
+ *  frame spilled into more than one block, the blocks are replaced
+ *  by a single one large enough to hold the whole frame.
+ */
+void ASGE::GLFrameArena::reset()
+{
+  if (blocks.size() > 1)
+  {
+    const auto total = std::accumulate(
+      blocks.begin(), blocks.end(), std::size_t{ 0 },
+      [](std::size_t sum, const Block& block) { return sum + block.size; });
+
+    blocks.clear();
+    blocks.push_back({ std::make_unique<std::byte[]>(total), total });
+    ++upstream;
+  }
+
+  current  = 0;
+  offset   = 0;
+  consumed = 0;
+}
+
+/**
+ *  Bumps an allocation from the current block.
+ *  When the current block is full the arena moves on to the next
+ *  one, adding a block big enough for the request if need be.
+ *
+ *  @param bytes The size of the allocation.
+ *  @param alignment The alignment of the allocation.
+ *  @return The allocated memory.
+ */
+void* ASGE::GLFrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  while (true)
+  {
+    auto& block = blocks[current];
+    void* ptr   = block.data.get() + offset;
+    auto space  = block.size - offset;
+    if (std::align(alignment, bytes, ptr, space) != nullptr)
+    {
+      const auto start = block.size - space;
+      consumed += start + bytes - offset;
+      offset    = start + bytes;
+      return ptr;
+    }
+
+    consumed += block.size - offset;
+    offset = 0;
+    if (++current == blocks.size())
+    {
+      const auto size = std::max(block_size, bytes + alignment);
+      blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+      ++upstream;
+    }
+  }
+}
+
+/**
+ *  Individual allocations are released together by reset.
+ */
+void ASGE::GLFrameArena::do_deallocate(
+  void* /*ptr*/, std::size_t /*bytes*/, std::size_t /*alignment*/) noexcept
+{
+}
+
+bool ASGE::GLFrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+  return this == &other;
+}
+
+std::size_t ASGE::GLFrameArena::capacity() const noexcept
+{
+  return std::accumulate(
+    blocks.begin(), blocks.end(), std::size_t{ 0 },
+    [](std::size_t sum, const Block& block) { return sum + block.size; });
+}
+
+std::size_t ASGE::GLFrameArena::used() const noexcept
+{
+  return consumed;
+}
+
+/**
+ *  @return The blocks allocated from the heap since the arena was created.
+ */
+std::size_t ASGE::GLFrameArena::allocations() const noexcept
+{
+  return upstream;
+}
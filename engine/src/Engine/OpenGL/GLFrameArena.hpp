@@ -0,0 +1,68 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#ifndef ASGE_GLFRAMEARENA_HPP
+#define ASGE_GLFRAMEARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace ASGE
+{
+  /**
+   * A linear allocator for data that only lives for a frame.
+   * Allocations are bumped from the end of a block and are never
+   * freed individually, everything is released at once by reset.
+   * The blocks are kept between frames, and once a frame has needed
+   * more than one they're merged, so after a few frames the arena
+   * settles into a single block and stops touching the heap.
+   * It's a memory resource, so it can back any of the pmr containers.
+   */
+  class GLFrameArena : public std::pmr::memory_resource
+  {
+   public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit GLFrameArena(std::size_t min_block_size = DEFAULT_BLOCK_SIZE);
+    ~GLFrameArena() override = default;
+
+    GLFrameArena(const GLFrameArena&) = delete;
+    GLFrameArena& operator=(const GLFrameArena&) = delete;
+
+    void reset();
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t used() const noexcept;
+    [[nodiscard]] std::size_t allocations() const noexcept;
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    struct Block
+    {
+      std::unique_ptr<std::byte[]> data{};
+      std::size_t size = 0;
+    };
+
+    std::vector<Block> blocks{};
+    std::size_t block_size = DEFAULT_BLOCK_SIZE;
+    std::size_t current    = 0;
+    std::size_t offset     = 0;
+    std::size_t consumed   = 0;
+    std::size_t upstream   = 0;
+  };
+}  // namespace ASGE
+
+#endif // ASGE_GLFRAMEARENA_HPP
@@ -13,28 +13,29 @@
 #include "FileIO.hpp"
 #include "GLLegacySpriteRenderer.hpp"
 #include "GLRenderer.hpp"
+#include "GLStateCache.hpp"
+#include "GLStaticSpriteLayer.hpp"
 #include "Logger.hpp"
 #include "OpenGL/Shaders/GLShaders.fs"
 #include "OpenGL/Shaders/GLShaders.vs"
+#include <algorithm>
+#include <numeric>
 
 ASGE::GLLegacySpriteRenderer::GLLegacySpriteRenderer()
 {
-  //find max ubo size...
-  Logging::DEBUG(std::to_string(QUAD_STORAGE_SIZE));
   GLint size = 0;
-  glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE , &size);
-  Logging::DEBUG("GL_MAX_UNIFORM_BLOCK_SIZE  is " + std::to_string(size) + " bytes.");
+  glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &size);
+  Logging::DEBUG("GL_MAX_TEXTURE_BUFFER_SIZE is " + std::to_string(size) + " texels.");
 }
 
 ASGE::GLLegacySpriteRenderer::~GLLegacySpriteRenderer()
 {
-  glDeleteBuffers(BUFFER_COUNT, &UBOs[0]);
+  GLStateCache::getInstance().forgetTexture(stream_texture);
+  GLStateCache::getInstance().forgetTexture(layer_texture);
+  glDeleteTextures(1, &stream_texture);
+  glDeleteTextures(1, &layer_texture);
+  glDeleteBuffers(1, &stream_buffer);
   glDeleteBuffers(1, &indicies_buffer);
-
-  for (GLsync buffer_sync : syncs)
-  {
-    glDeleteSync(buffer_sync);
-  }
 }
 
 bool ASGE::GLLegacySpriteRenderer::init()
@@ -43,24 +44,14 @@ bool ASGE::GLLegacySpriteRenderer::init()
   basic_sprite_shader                 = sprite_shader->getShaderID();
   basic_text_shader                   = initShader(vs_instancing_legacy, fs_text)->getShaderID();
   active_shader                       = sprite_shader;
-  sprite_shader->use();
+  setupTextureSlots(*sprite_shader);
   setupGlobalShaderData();
 
-  using GLRenderConstants::QUAD_VERTICES;
-  UBO_buffer_idx = 0;
+  // the quad's corners are generated from gl_VertexID, so the
+  // vertex array only needs the element buffer
   glGenVertexArrays(1, &this->VAO);
   glBindVertexArray(this->VAO);
 
-  // TODO move to actual location layouts inside shader
-  int position_loc = sprite_shader->getLocation("position");     // vec2
-
-  glGenBuffers(1, &vertex_buffer);
-  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD_VERTICES), &QUAD_VERTICES, GL_STATIC_DRAW);
-  glVertexAttribPointer(position_loc, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glVertexAttribDivisor(position_loc, 0);
-  glEnableVertexAttribArray(position_loc);
-
   using GLRenderConstants::QUAD_INDICIES;
   glGenBuffers(1, &indicies_buffer);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicies_buffer);
@@ -79,38 +70,81 @@ bool ASGE::GLLegacySpriteRenderer::init()
   //  i.e. PROJECTION_UBO_BIND = global_shader_data...
  map_uniform_block(basic_sprite_shader, "global_shader_data", GLRenderConstants::PROJECTION_UBO_BIND);
  map_uniform_block(basic_text_shader, "global_shader_data", GLRenderConstants::PROJECTION_UBO_BIND);
- map_uniform_block(basic_sprite_shader, "render_quads", GLRenderConstants::QUAD_DATA_UBO_BIND);
- map_uniform_block(basic_text_shader, "render_quads", GLRenderConstants::QUAD_DATA_UBO_BIND);
 
- constexpr GLbitfield MAPPING_FLAGS = GL_MAP_WRITE_BIT;
- constexpr GLbitfield STORAGE_FLAGS = GL_DYNAMIC_STORAGE_BIT | MAPPING_FLAGS;
+  // the stream holds a frame's quads, as far as a buffer texture can
+  GLint max_texels = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max_texels);
+  stream_capacity = std::max(
+    std::min(quad_budget, static_cast<GLuint>(max_texels / TEXELS_PER_QUAD)), 1U);
 
- glGenBuffers(BUFFER_COUNT, &UBOs[0]);
-  for (const auto& UBO : UBOs)
-  {
-    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
-    glBufferData(GL_UNIFORM_BUFFER, UBOSize(), nullptr, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-  }
+  glGenBuffers(1, &stream_buffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, stream_buffer);
+  glBufferData(
+    GL_TEXTURE_BUFFER,
+    static_cast<GLsizeiptr>(stream_capacity) * QUAD_STORAGE_SIZE,
+    nullptr,
+    GL_STREAM_DRAW);
+  stream_head = 0;
+
+  glGenTextures(1, &stream_texture);
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_BUFFER, stream_texture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, stream_buffer);
+  glGenTextures(1, &layer_texture);
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_BUFFER, 0);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
 
+  Logging::DEBUG("Legacy quad stream holds " + std::to_string(stream_capacity) + " quads");
   ClearGLErrors(__PRETTY_FUNCTION__);
   return true;
 }
 
+/**
+ *  Binds a buffer texture to the quad buffer's texture unit.
+ *
+ *  @param texture The buffer texture holding the quads.
+ */
+void ASGE::GLLegacySpriteRenderer::bindQuadBuffer(GLuint texture) const
+{
+  auto& state = GLStateCache::getInstance();
+  state.bindTexture(GLRenderConstants::QUAD_TBO_UNIT, GL_TEXTURE_BUFFER, texture);
+  state.activeTexture(0);
+}
+
+/**
+ *  Looks up the active shader's quad offset uniform.
+ *  Locations are cached per program. The first time a program is
+ *  seen its quad buffer sampler is also pointed at the right unit,
+ *  so the active shader must already be in use.
+ *
+ *  @return The location of quad_buffer_offset, or -1 if unused.
+ */
+GLint ASGE::GLLegacySpriteRenderer::quadOffsetLocation()
+{
+  const auto program = static_cast<GLuint>(active_shader->getShaderID());
+  auto [location, inserted] = offset_locations.try_emplace(program, -1);
+  if (inserted)
+  {
+    location->second = glGetUniformLocation(program, "quad_buffer_offset");
+    glUniform1i(
+      glGetUniformLocation(program, "quad_buffer"), static_cast<GLint>(GLRenderConstants::QUAD_TBO_UNIT));
+  }
+
+  return location->second;
+}
+
 int ASGE::GLLegacySpriteRenderer::render(
-  std::vector<AnotherRenderBatch>&& batches)
+  RenderBatches&& batches)
 {
-  glBindBufferRange(GL_UNIFORM_BUFFER, GLRenderConstants::QUAD_DATA_UBO_BIND, UBOs[UBO_buffer_idx], 0, UBOSize());
+  bindQuadBuffer(stream_texture);
 
   int draw_count = 0;
   for(const auto& batch : batches)
   {
     apply(batch.state);
-    bindTexture(batch.texture_id);
+    bindTextures(batch.textures);
     bindShader(batch.shader_id, batch.distance);
 
-    GLint loc = glGetUniformLocation(active_shader->getShaderID(), "quad_buffer_offset");
-    glUniform1i(loc, batch.start_idx);
+    glUniform1i(quadOffsetLocation(), static_cast<GLint>(upload_base + batch.start_idx));
     ClearGLErrors("Setting uniform");
 
     glDrawElementsInstanced(
@@ -124,51 +158,97 @@ int ASGE::GLLegacySpriteRenderer::render(
     ++draw_count;
   }
 
-  lockBuffer(syncs[UBO_buffer_idx]);
-  UBO_buffer_idx = (UBO_buffer_idx + 1) % BUFFER_COUNT;
-
   ClearGLErrors(__PRETTY_FUNCTION__);
   return draw_count;
 }
 
-constexpr GLsizei ASGE::GLLegacySpriteRenderer::UBOSize() noexcept
+/**
+ *  Renders a retained sprite layer.
+ *  The layer's buffer is viewed through its own buffer texture, so
+ *  each batch is drawn in one call by offsetting into the layer.
+ *
+ *  @param[in] layer The layer to render, its data must be up to date.
+ *  @param[in] state The render state to draw the layer with.
+ *  @return The number of draw calls issued.
+ */
+int ASGE::GLLegacySpriteRenderer::render(const GLStaticSpriteLayer& layer, RenderState* state)
 {
-  return QUAD_STORAGE_SIZE * GLRenderConstants::QUAD_UBO_LIMIT;
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_BUFFER, layer_texture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, layer.getBuffer());
+  bindQuadBuffer(layer_texture);
+
+  int draw_count = 0;
+  for (const auto& batch : layer.getBatches())
+  {
+    apply(state);
+    bindTextures(batch.textures);
+    bindShader(batch.shader_id, 0);
+
+    glUniform1i(quadOffsetLocation(), static_cast<GLint>(batch.start_idx));
+    glDrawElementsInstanced(
+      GL_TRIANGLES,
+      sizeof(GLRenderConstants::QUAD_INDICIES),
+      GL_UNSIGNED_BYTE,
+      ((void*)nullptr),
+      static_cast<GLsizei>(batch.instance_count));
+    ClearGLErrors("Layer Rendering");
+    ++draw_count;
+  }
+
+  return draw_count;
 }
 
+/**
+ *  Streams a range of quads to the head of the buffer.
+ *  The range is written unsynchronised, as nothing written since
+ *  the buffer was last orphaned is ever overwritten. When the range
+ *  doesn't fit the buffer is orphaned and the stream starts again,
+ *  the driver keeps the old storage alive for any pending draws.
+ *
+ *  @param range The first and last quad to upload.
+ *  @param payloads The GPU data for the quads.
+ *  @return The last quad that was uploaded.
+ */
 ASGE::QuadIter
-ASGE::GLLegacySpriteRenderer::upload(const ASGE::QuadRange& range)
+ASGE::GLLegacySpriteRenderer::upload(const ASGE::QuadRange& range, const GPUQuadList& payloads)
 {
-  waitBuffer(syncs[UBO_buffer_idx]);
-  GLVMSG(__PRETTY_FUNCTION__, glBindBuffer, GL_UNIFORM_BUFFER, UBOs[UBO_buffer_idx]);
+  const auto remaining = static_cast<GLuint>(std::distance(range.begin, range.end) + 1);
+  const auto count     = std::min(remaining, stream_capacity);
 
-  GLvoid* gpu_mem = GLMSG(
+  GLVMSG(__PRETTY_FUNCTION__, glBindBuffer, GL_TEXTURE_BUFFER, stream_buffer);
+  if (stream_head + count > stream_capacity)
+  {
+    glBufferData(
+      GL_TEXTURE_BUFFER,
+      static_cast<GLsizeiptr>(stream_capacity) * QUAD_STORAGE_SIZE,
+      nullptr,
+      GL_STREAM_DRAW);
+    stream_head = 0;
+  }
+
+  auto* gpu_quads = static_cast<GPUQuad*>(GLMSG(
     __PRETTY_FUNCTION__,
     glMapBufferRange,
-    GL_UNIFORM_BUFFER,
-    0,
-    UBOSize(),
-    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    GL_TEXTURE_BUFFER,
+    static_cast<GLintptr>(stream_head) * QUAD_STORAGE_SIZE,
+    static_cast<GLsizeiptr>(count) * QUAD_STORAGE_SIZE,
+    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
 
-  int64_t uploaded = 0;
   auto cpu_quad = range.begin;
-
-  do
+  for (GLuint i = 0; i < count; ++i, ++cpu_quad)
   {
-    auto* gpu_quad = &static_cast<GPUQuad*>(gpu_mem)[uploaded++];
-    memcpy(gpu_quad, &cpu_quad->gpu_data, sizeof(GPUQuad));
-
-    /// if buffer limit is reached break the loop
-    if(uploaded == GLRenderConstants::QUAD_UBO_LIMIT)
-    {
-      cpu_quad++;
-      break;
-    }
-  } while (cpu_quad++ != range.end);
+    // the slot is added whilst gathering, the payload is never written to twice
+    auto quad = payloads[cpu_quad->payload_idx];
+    quad.slot = cpu_quad->slot;
+    memcpy(&gpu_quads[i], &quad, sizeof(GPUQuad));
+  }
 
   /// unmap the buffer
-  GLVMSG(__PRETTY_FUNCTION__, glUnmapBuffer,GL_UNIFORM_BUFFER);
-  GLVMSG(__PRETTY_FUNCTION__, glBindBuffer,GL_UNIFORM_BUFFER, 0);
+  GLVMSG(__PRETTY_FUNCTION__, glUnmapBuffer, GL_TEXTURE_BUFFER);
+  GLVMSG(__PRETTY_FUNCTION__, glBindBuffer, GL_TEXTURE_BUFFER, 0);
+
+  upload_base = stream_head;
+  stream_head += count;
 
   /// return the last quad successfully uploaded
   return std::prev(cpu_quad);
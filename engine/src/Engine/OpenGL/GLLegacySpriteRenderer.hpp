@@ -13,6 +13,7 @@
 #ifndef ASGE_GLLEGACYSPRITERENDERER_HPP
 #define ASGE_GLLEGACYSPRITERENDERER_HPP
 #include "CGLSpriteRenderer.hpp"
+#include <unordered_map>
 namespace ASGE
 {
   /**
@@ -21,6 +22,11 @@ namespace ASGE
    * used, including the use of SSBOs and named bindings. Mainly,
    * this class is motivated around the use of OSX but also older GPUs
    * such as intel iGPU's.
+   *
+   * Quads are streamed into a single large buffer that the vertex
+   * shader reads through a texture buffer object. Uploads are written
+   * unsynchronised at the head of the buffer, which is orphaned
+   * whenever it fills, so the CPU never waits on the GPU.
    */
   class GLLegacySpriteRenderer : public CGLSpriteRenderer
   {
@@ -31,17 +37,26 @@ namespace ASGE
     GLLegacySpriteRenderer operator=(const GLLegacySpriteRenderer&) = delete;
 
     bool init() override;
-    QuadIter upload(const QuadRange& range) override;
-    int render(std::vector<AnotherRenderBatch>&& batches) override;
+    QuadIter upload(const QuadRange& range, const GPUQuadList& payloads) override;
+    int render(RenderBatches&& batches) override;
+    int render(const GLStaticSpriteLayer& layer, RenderState* state) override;
     [[nodiscard]] GLRenderer::RenderLib getRenderLib() const override;
 
    private:
-    static constexpr GLsizei UBOSize() noexcept;
-    static constexpr GLsizei BUFFER_COUNT = 3;
-    std::array<GLuint, BUFFER_COUNT> UBOs  {0};
-    std::array<GLsync, BUFFER_COUNT> syncs {nullptr};
-    GLuint UBO_buffer_idx = 0;
+    static constexpr GLint TEXELS_PER_QUAD = QUAD_STORAGE_SIZE / 16;
+    void bindQuadBuffer(GLuint texture) const;
+    GLint quadOffsetLocation();
+
+    GLuint stream_buffer  = 0;
+    GLuint stream_texture = 0;
+    GLuint layer_texture  = 0;
+    GLuint stream_capacity = 0;
+    GLuint stream_head     = 0;
+    GLuint upload_base     = 0;
     GLuint indicies_buffer = 0;
+
+    // program -> location of its quad_buffer_offset uniform
+    std::unordered_map<GLuint, GLint> offset_locations{};
   };
 }  // namespace ASGE
 #endif // ASGE_GLLEGACYSPRITERENDERER_HPP
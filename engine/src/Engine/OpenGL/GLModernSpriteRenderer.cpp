@@ -16,10 +16,28 @@
 #include <OpenGL/GLModernSpriteRenderer.hpp>
 #include <OpenGL/GLRenderer.hpp>
 #include <OpenGL/GLSprite.hpp>
+#include <OpenGL/GLStateCache.hpp>
+#include <OpenGL/GLStaticSpriteLayer.hpp>
 #include <OpenGL/Shaders/GLShaders.fs>
 #include <OpenGL/Shaders/GLShaders.vs>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
 #include <vector>
 
+namespace
+{
+  /// whether two batches can be drawn by the same multi-draw
+  bool canMerge(
+    const ASGE::AnotherRenderBatch& lhs, const ASGE::AnotherRenderBatch& rhs, bool same_state)
+  {
+    return lhs.textures == rhs.textures && lhs.shader_id == rhs.shader_id &&
+           lhs.distance == rhs.distance &&
+           (same_state || lhs.state == rhs.state || *lhs.state == *rhs.state);
+  }
+}  // namespace
+
 /**
  *  The constructor for the sprite renderer.
  *  The sprite renderer requires some shared data in order to work. This
@@ -42,12 +60,6 @@ ASGE::GLModernSpriteRenderer::GLModernSpriteRenderer()
   std::stringstream ssbo_max_size;
   ssbo_max_size << "GL_MAX_SHADER_STORAGE_BLOCK_SIZE is " << size << " bytes.";
   Logging::DEBUG(ssbo_max_size.str());
-
-  std::stringstream ssbo_allocated;
-  ssbo_allocated << "SSBO_ALLOCATED_BUFFER_SIZE is " << SSBOSize() * 3
-                 << " bytes.";
-
-  Logging::DEBUG(ssbo_allocated.str());
   Logging::DEBUG("GPUQuad size: " + std::to_string(sizeof(ASGE::GPUQuad)));
   Logging::DEBUG("RenderQuad size: " + std::to_string(sizeof(ASGE::RenderQuad)));
 }
@@ -64,10 +76,10 @@ ASGE::GLModernSpriteRenderer::~GLModernSpriteRenderer()
   if (glfwGetCurrentContext() != nullptr)
   {
     glDeleteBuffers(1, &SSBO);
-    for (GLsync buffer_sync : triple_buffer.syncs)
-    {
-      glDeleteSync(buffer_sync);
-    }
+    glDeleteBuffers(1, &element_buffer);
+    glDeleteBuffers(1, &instance_buffer);
+    glDeleteBuffers(1, &indirect_buffer);
+    glDeleteBuffers(1, &order_buffer);
   }
 }
 
@@ -87,37 +99,48 @@ bool ASGE::GLModernSpriteRenderer::init()
   SHADER_LIB::GLShader* sprite_shader = initShader(vs_instancing, fs_instancing);
   basic_sprite_shader                 = sprite_shader->getShaderID();
   basic_text_shader                   = initShader(vs_instancing, fs_text)->getShaderID();
-  sprite_shader->use();
   active_shader = sprite_shader;
+  setupTextureSlots(*sprite_shader);
   setupGlobalShaderData();
 
-  using GLRenderConstants::QUAD_VERTICES;
-  buffer_idx = 0;
+  // the quad's corners are generated from gl_VertexID, so the
+  // vertex array only needs the indices and each instance's quad
   glGenVertexArrays(1, &this->VAO);
   glBindVertexArray(this->VAO);
 
-  // TODO move to actual location layouts inside shader
-  int position_loc = sprite_shader->getLocation("position"); // vec2
-
-  glGenBuffers(1, &vertex_buffer);
-  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD_VERTICES), QUAD_VERTICES, GL_STATIC_DRAW);
-  glVertexAttribPointer(position_loc, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glVertexAttribDivisor(position_loc, 0);
-  glEnableVertexAttribArray(position_loc);
+  using GLRenderConstants::QUAD_INDICIES;
+  glCreateBuffers(1, &element_buffer);
+  glNamedBufferStorage(element_buffer, sizeof(QUAD_INDICIES), &QUAD_INDICIES[0], 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, element_buffer);
 
-  constexpr GLbitfield MAPPING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-  constexpr GLbitfield STORAGE_FLAGS = GL_DYNAMIC_STORAGE_BIT | MAPPING_FLAGS;
+  // the whole quad ring is bound as a single block, so the budget
+  // is limited by the largest block the driver supports
+  GLint max_block_size = 0;
+  glGetIntegerv(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &max_block_size);
+  const auto max_budget = static_cast<GLuint>(max_block_size) / (QUAD_STORAGE_SIZE * FRAMES_IN_FLIGHT);
+  static_assert(
+    std::numeric_limits<GLint>::max() / QUAD_STORAGE_SIZE <= GLRenderConstants::QUAD_ORDER_INDEX_MASK,
+    "The quad ring can hold more quads than the sorted order can index");
+  quad_budget = std::clamp(quad_budget, MIN_QUAD_CAPACITY, std::max(max_budget, MIN_QUAD_CAPACITY));
 
-  const auto MAX_SSBO_CAPACITY = SSBOSize() * ASGE::GLModernSpriteRenderer::VBOTripleBuffer::BUFFER_COUNT;
+  // without gl_BaseInstance an instanced attribute is the only way
+  // for the shader to see the base instance, so an identity buffer
+  // is used to turn base instance + instance id into the quad index
+  reserveQuadIndices(quad_budget);
+  glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+  glVertexAttribIPointer(GLRenderConstants::QUAD_INDEX_ATTRIB, 1, GL_UNSIGNED_INT, 0, nullptr);
+  glVertexAttribDivisor(GLRenderConstants::QUAD_INDEX_ATTRIB, 1);
+  glEnableVertexAttribArray(GLRenderConstants::QUAD_INDEX_ATTRIB);
 
-  glCreateBuffers(1, &SSBO);
-  glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GLRenderConstants::QUAD_DATA_SSBO_BIND, SSBO, 0, MAX_SSBO_CAPACITY);
-  glNamedBufferStorage(SSBO, MAX_SSBO_CAPACITY, nullptr, STORAGE_FLAGS);
+  allocateQuadBuffers(std::min(MIN_QUAD_CAPACITY, quad_budget));
 
-  triple_buffer.buffers[0] = glMapNamedBufferRange(SSBO, 0, MAX_SSBO_CAPACITY, MAPPING_FLAGS | GL_MAP_FLUSH_EXPLICIT_BIT);
-  triple_buffer.buffers[1] = static_cast<GLbyte*>(triple_buffer.buffers[0]) + SSBOSize();
-  triple_buffer.buffers[2] = static_cast<GLbyte*>(triple_buffer.buffers[1]) + SSBOSize();
+  constexpr GLbitfield MAPPING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  const auto MAX_INDIRECT_CAPACITY = IndirectSize() * FRAMES_IN_FLIGHT;
+  glCreateBuffers(1, &indirect_buffer);
+  glNamedBufferStorage(indirect_buffer, MAX_INDIRECT_CAPACITY, nullptr, MAPPING_FLAGS);
+  mapped_commands = static_cast<DrawElementsIndirectCommand*>(
+    glMapNamedBufferRange(indirect_buffer, 0, MAX_INDIRECT_CAPACITY, MAPPING_FLAGS));
+  command_ring.reset(GLRenderConstants::INDIRECT_COMMAND_LIMIT * FRAMES_IN_FLIGHT, 1);
 
   checkForErrors();
   return true;
@@ -144,78 +167,467 @@ bool ASGE::GLModernSpriteRenderer::init()
  *  param [out] rgba The vec4 representation of colour
  */
 
-constexpr GLsizei ASGE::GLModernSpriteRenderer::SSBOSize() noexcept
+/**
+ *  Grows the identity buffer to cover at least count quads.
+ *  Streamed uploads never exceed the budget it starts with, but a
+ *  static layer can hold more quads than that. The old buffer is
+ *  orphaned and the vertex array is pointed at the new one.
+ *
+ *  @param count The number of quad indices needed.
+ */
+void ASGE::GLModernSpriteRenderer::reserveQuadIndices(GLuint count)
 {
-  return GLRenderConstants::MATRIX_STORAGE_SIZE +
-         GLRenderConstants::UV_STORAGE_SIZE +
-         GLRenderConstants::COLOUR_STORAGE_SIZE;
+  if (count <= quad_index_count)
+  {
+    return;
+  }
+
+  const auto capacity = std::max(count, quad_index_count * 2);
+  std::vector<GLuint> quad_indices(capacity);
+  std::iota(quad_indices.begin(), quad_indices.end(), 0);
+
+  glDeleteBuffers(1, &instance_buffer);
+  glCreateBuffers(1, &instance_buffer);
+  glNamedBufferStorage(
+    instance_buffer,
+    static_cast<GLsizeiptr>(quad_indices.size() * sizeof(GLuint)),
+    quad_indices.data(),
+    0);
+
+  // the attribute's binding index matches its location
+  glVertexArrayVertexBuffer(
+    VAO, GLRenderConstants::QUAD_INDEX_ATTRIB, instance_buffer, 0, static_cast<GLsizei>(sizeof(GLuint)));
+  quad_index_count = capacity;
 }
 
-int ASGE::GLModernSpriteRenderer::render(
-  std::vector<AnotherRenderBatch>&& batches)
+/**
+ *  (Re)allocates the quad and order rings.
+ *  Any previous buffers are orphaned, GL keeps them alive until
+ *  the GPU has finished with them, so nothing needs to wait. Must
+ *  only be called between frames, whilst the sprite batch holds no
+ *  reserved quads.
+ *
+ *  @param capacity The number of quads a frame can hold.
+ */
+void ASGE::GLModernSpriteRenderer::allocateQuadBuffers(GLuint capacity)
+{
+  constexpr GLbitfield MAPPING_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  constexpr GLbitfield STORAGE_FLAGS = GL_DYNAMIC_STORAGE_BIT | MAPPING_FLAGS;
+  constexpr auto INDEX_SIZE          = static_cast<GLint>(sizeof(GLuint));
+
+  glDeleteBuffers(1, &SSBO);
+  glDeleteBuffers(1, &order_buffer);
+
+  const auto ring_size    = capacity * FRAMES_IN_FLIGHT;
+  const auto quad_bytes   = static_cast<GLsizeiptr>(ring_size) * QUAD_STORAGE_SIZE;
+  const auto order_bytes  = static_cast<GLsizeiptr>(ring_size) * INDEX_SIZE;
+
+  // the sprite batch writes quads as they're submitted, so the whole
+  // buffer stays bound and the mapping is coherent rather than flushed
+  glCreateBuffers(1, &SSBO);
+  glNamedBufferStorage(SSBO, quad_bytes, nullptr, STORAGE_FLAGS);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GLRenderConstants::QUAD_DATA_SSBO_BIND, SSBO);
+  mapped_quads = static_cast<GPUQuad*>(glMapNamedBufferRange(SSBO, 0, quad_bytes, MAPPING_FLAGS));
+  quad_ring.reset(ring_size, 1);
+
+  // bound ranges of the order buffer need to start on an aligned index
+  GLint alignment = 1;
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+  glCreateBuffers(1, &order_buffer);
+  glNamedBufferStorage(order_buffer, order_bytes, nullptr, MAPPING_FLAGS);
+  mapped_order = static_cast<GLuint*>(glMapNamedBufferRange(order_buffer, 0, order_bytes, MAPPING_FLAGS));
+  order_ring.reset(
+    ring_size, static_cast<GLuint>(std::lcm(INDEX_SIZE, std::max(alignment, 1)) / INDEX_SIZE));
+
+  quad_capacity      = capacity;
+  SSBO_current_limit = capacity;
+  high_water         = 0;
+  low_usage_frames   = 0;
+
+  Logging::DEBUG(
+    "Quad buffers sized for " + std::to_string(capacity) + " quads per frame, " +
+    std::to_string((quad_bytes + order_bytes) / 1024) + "KB");
+}
+
+/**
+ *  Resizes the quad buffers to fit the frame that just ended.
+ *  A frame that overflows its share of the rings grows them, at
+ *  least doubling their size, up to the budget. After a sustained
+ *  period of using less than a quarter of their capacity they're
+ *  halved, but never below the minimum.
+ */
+void ASGE::GLModernSpriteRenderer::resizeQuadBuffers()
+{
+  high_water = std::max(high_water, frame_quads);
+
+  auto capacity = quad_capacity;
+  if (frame_quads > quad_capacity && quad_capacity < quad_budget)
+  {
+    capacity = std::min(quad_budget, std::max(quad_capacity * 2, frame_quads));
+  }
+  else if (frame_quads < quad_capacity / 4 && quad_capacity > MIN_QUAD_CAPACITY)
+  {
+    if (++low_usage_frames >= SHRINK_AFTER_FRAMES)
+    {
+      capacity = std::max(MIN_QUAD_CAPACITY, quad_capacity / 2);
+    }
+  }
+  else
+  {
+    low_usage_frames = 0;
+  }
+
+  frame_quads = 0;
+  if (capacity != quad_capacity)
+  {
+    allocateQuadBuffers(capacity);
+  }
+}
+
+GLuint ASGE::GLModernSpriteRenderer::quadCapacity() const noexcept
+{
+  return quad_capacity;
+}
+
+constexpr GLsizeiptr ASGE::GLModernSpriteRenderer::IndirectSize() noexcept
 {
+  return sizeof(DrawElementsIndirectCommand) * GLRenderConstants::INDIRECT_COMMAND_LIMIT;
+}
+
+/**
+ *  Submits the batches using as few draw calls as possible.
+ *  Consecutive batches that share textures, shader and an equivalent
+ *  render state are grouped together. Each group reserves its commands
+ *  from the indirect buffer's ring and is drawn using a
+ *  single multi-draw. Contiguous ranges within a group collapse into
+ *  a single command. Each command's base instance selects the quads.
+ *
+ *  @param[in] batches The batches to draw.
+ *  @param[in] state_override If set, used in place of the batch states.
+ *  @return The number of draw calls issued.
+ */
+int ASGE::GLModernSpriteRenderer::submit(const RenderBatches& batches, RenderState* state_override)
+{
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer);
+
   int draw_count = 0;
-  for (const auto& batch : batches)
+  for (auto group_begin = batches.cbegin(); group_begin != batches.cend();)
   {
-    apply(batch.state);
-    bindTexture(batch.texture_id);
-    bindShader(batch.shader_id, batch.distance);
+    auto group_end = std::next(group_begin);
+    while (group_end != batches.cend() && canMerge(*group_begin, *group_end, state_override != nullptr))
+    {
+      ++group_end;
+    }
 
-    glUniform1i(GLRenderConstants::OFFSET_UBO_BIND, batch.start_idx);
-    ClearGLErrors("Setting uniform");
+    apply(state_override != nullptr ? state_override : group_begin->state);
+    bindTextures(group_begin->textures);
+    bindShader(group_begin->shader_id, group_begin->distance);
 
-    glDrawElementsInstancedBaseInstance(
-      GL_TRIANGLES,
-      sizeof(GLRenderConstants::QUAD_INDICIES),
-      GL_UNSIGNED_BYTE,
-      GLRenderConstants::QUAD_INDICIES,
-      batch.instance_count,
-      0);
+    const auto group_size = static_cast<GLuint>(std::distance(group_begin, group_end));
+    if (group_size <= command_ring.capacity())
+    {
+      const auto first_command = reserve(command_ring, group_size);
+      auto next_command        = first_command;
+      for (auto batch = group_begin; batch != group_end; ++batch)
+      {
+        auto* previous = next_command != first_command ? &mapped_commands[next_command - 1] : nullptr;
+        if (previous != nullptr && previous->base_instance + previous->instance_count == batch->start_idx)
+        {
+          previous->instance_count += batch->instance_count;
+          continue;
+        }
+
+        mapped_commands[next_command++] = DrawElementsIndirectCommand{
+          sizeof(GLRenderConstants::QUAD_INDICIES), batch->instance_count, 0, 0, batch->start_idx
+        };
+      }
 
+      glMultiDrawElementsIndirect(
+        GL_TRIANGLES,
+        GL_UNSIGNED_BYTE,
+        reinterpret_cast<const void*>(
+          sizeof(DrawElementsIndirectCommand) * first_command),
+        static_cast<GLsizei>(next_command - first_command),
+        0);
+    }
+    else
+    {
+      // more commands than the ring can hold, so fall back to direct draws
+      for (auto batch = group_begin; batch != group_end; ++batch)
+      {
+        glDrawElementsInstancedBaseInstance(
+          GL_TRIANGLES,
+          sizeof(GLRenderConstants::QUAD_INDICIES),
+          GL_UNSIGNED_BYTE,
+          nullptr,
+          batch->instance_count,
+          batch->start_idx);
+      }
+    }
+
+    ClearGLErrors("Submitting draws");
     ++draw_count;
+    group_begin = group_end;
   }
 
-  lockBuffer(triple_buffer.syncs[buffer_idx]);
-  buffer_idx = (buffer_idx + 1) % VBOTripleBuffer::BUFFER_COUNT;
   return draw_count;
 }
 
-ASGE::QuadIter
-ASGE::GLModernSpriteRenderer::upload(const ASGE::QuadRange& range)
+int ASGE::GLModernSpriteRenderer::render(
+  RenderBatches&& batches)
+{
+  if (culler != nullptr)
+  {
+    return submitCulled(batches);
+  }
+
+  return submit(batches, nullptr);
+}
+
+/**
+ *  Culls the uploaded quads on the GPU and then draws them.
+ *  Batches are grouped the same way as submit groups them, as long
+ *  as their quads are contiguous, and each group is culled against
+ *  its own render state's view. Every group is then drawn with the
+ *  command the culler wrote for it, so the survivors are never read
+ *  back. If the upload can't be culled it's submitted as normal.
+ *
+ *  @param[in] batches The batches to draw, from the latest upload.
+ *  @return The number of draw calls issued.
+ */
+int ASGE::GLModernSpriteRenderer::submitCulled(const RenderBatches& batches)
+{
+  cull_groups.clear();
+  cull_group_batches.clear();
+  for (auto batch = batches.cbegin(); batch != batches.cend(); ++batch)
+  {
+    auto* group = cull_groups.empty() ? nullptr : &cull_groups.back();
+    if (
+      group != nullptr && canMerge(*cull_group_batches.back(), *batch, false) &&
+      group->first + group->count == batch->start_idx)
+    {
+      group->count += batch->instance_count;
+      continue;
+    }
+
+    const auto& view = batch->state->view;
+    auto& added      = cull_groups.emplace_back();
+    added.view       = glm::vec4{ view.min_x, view.max_x, view.min_y, view.max_y };
+    added.first      = batch->start_idx;
+    added.count      = batch->instance_count;
+    cull_group_batches.emplace_back(batch);
+  }
+
+  const auto instance_count = cull_groups.empty() ? 0U : cull_groups.back().first + cull_groups.back().count;
+  const bool culled         = culler->cull(instance_count, cull_groups);
+
+  // the culling passes replace the program in use
+  GLStateCache::getInstance().useProgram(
+    active_shader != nullptr ? static_cast<GLuint>(active_shader->getShaderID()) : 0);
+  if (!culled)
+  {
+    return submit(batches, nullptr);
+  }
+
+  culler->bindResults();
+  for (std::size_t i = 0; i < cull_groups.size(); ++i)
+  {
+    const auto& batch = *cull_group_batches[i];
+    apply(batch.state);
+    bindTextures(batch.textures);
+    bindShader(batch.shader_id, batch.distance);
+    glDrawElementsIndirect(
+      GL_TRIANGLES,
+      GL_UNSIGNED_BYTE,
+      reinterpret_cast<const void*>(static_cast<std::uintptr_t>(i) * GLComputeCuller::COMMAND_SIZE));
+  }
+
+  ClearGLErrors("Submitting culled draws");
+  return static_cast<int>(cull_groups.size());
+}
+
+/**
+ *  Enables culling the streamed quads in a compute pass.
+ *  Retained layers are always drawn in full.
+ *
+ *  @param enabled Whether to cull on the GPU.
+ */
+void ASGE::GLModernSpriteRenderer::setGpuCulling(bool enabled)
+{
+  if (!enabled)
+  {
+    culler.reset();
+    return;
+  }
+
+  culler = std::make_unique<GLComputeCuller>();
+  if (!culler->init(quad_budget))
+  {
+    Logging::ERRORS("GPU culling is unavailable and has been disabled");
+    culler.reset();
+  }
+}
+
+/**
+ *  Fences the frame's allocations from both rings.
+ *  Any earlier frames the GPU has already finished with are
+ *  released without waiting, the rest remain in flight.
+ *
+ *  @return The stats collected during the frame.
+ */
+ASGE::Renderer::RenderStats ASGE::GLModernSpriteRenderer::endFrame()
+{
+  for (auto* ring : { &quad_ring, &order_ring, &command_ring })
+  {
+    ring->fence();
+    ring->retireCompleted();
+  }
+
+  frame_stats.bytes_in_flight =
+    static_cast<std::size_t>(quad_ring.inFlight()) * QUAD_STORAGE_SIZE +
+    static_cast<std::size_t>(order_ring.inFlight()) * sizeof(GLuint) +
+    static_cast<std::size_t>(command_ring.inFlight()) * sizeof(DrawElementsIndirectCommand);
+
+  resizeQuadBuffers();
+  frame_stats.quad_capacity   = quad_capacity;
+  frame_stats.quad_high_water = high_water;
+
+  return CGLSpriteRenderer::endFrame();
+}
+
+ASGE::GPUQuad* ASGE::GLModernSpriteRenderer::mappedQuads() noexcept
 {
-  waitBuffer(triple_buffer.syncs[buffer_idx]);
-  auto *gpu_data = triple_buffer.buffers[buffer_idx];
+  return mapped_quads;
+}
+
+/**
+ *  Reserves quads for the sprite batch to write into.
+ *  The indices are absolute, as the whole quad buffer stays bound.
+ *  Unlike the other rings, the quads are reserved well before they
+ *  are drawn. So if the current frame alone has filled the ring, it
+ *  can only be fenced early once the batch has drawn its quads.
+ *
+ *  @param count The number of quads, at most a single batch's worth.
+ *  @param drawn Whether every quad reserved so far has been drawn.
+ *  @return The index of the first reserved quad, or nullopt if the
+ *  batch needs to flush before the ring can be fenced.
+ */
+std::optional<GLuint> ASGE::GLModernSpriteRenderer::reserveQuads(GLuint count, bool drawn)
+{
+  if (!drawn)
+  {
+    auto offset = quad_ring.allocate(count);
+    while (!offset.has_value() && quad_ring.hasPendingFence())
+    {
+      waitBuffer(quad_ring.oldestFence());
+      quad_ring.retire();
+      offset = quad_ring.allocate(count);
+    }
+    return offset;
+  }
 
-  GLsizeiptr uploaded = 0;
-  auto cpu_quad = range.begin;
-  do
+  return reserve(quad_ring, count);
+}
+
+/**
+ *  Reserves space in one of the streaming rings.
+ *  When the ring is full the oldest frame is waited on and released.
+ *  If the current frame alone has filled the ring, it's fenced early
+ *  so that the space it has already drawn from can be reclaimed.
+ *  Everything allocated from the ring must already have been drawn.
+ *
+ *  @param ring The ring to allocate from.
+ *  @param count The number of elements needed, at most the ring's capacity.
+ *  @return The offset of the reserved elements.
+ */
+GLuint ASGE::GLModernSpriteRenderer::reserve(GLRingAllocator& ring, GLuint count)
+{
+  auto offset = ring.allocate(count);
+  while (!offset.has_value())
   {
-    auto *gpu_quad = &reinterpret_cast<GPUQuad*>(gpu_data)[uploaded++];
-    memcpy(gpu_quad, &cpu_quad->gpu_data, sizeof(GPUQuad));
-    if (uploaded == SSBO_current_limit)
+    if (!ring.hasPendingFence())
     {
-      Logging::DEBUG("Reached SSBO Limit");
-      break;
+      ring.fence();
     }
-  } while (cpu_quad++ != range.end);
 
-  /// flush the memory to the GPU
-  GLVMSG(
-    __PRETTY_FUNCTION__,
-    glFlushMappedNamedBufferRange,
-    SSBO,
-    SSBOSize() * buffer_idx,
-    QUAD_STORAGE_SIZE * uploaded);
+    waitBuffer(ring.oldestFence());
+    ring.retire();
+    offset = ring.allocate(count);
+  }
+
+  return *offset;
+}
+
+/**
+ *  Renders a retained sprite layer.
+ *  The layer's buffer is bound in place of the streamed quads, and
+ *  as its quads are already sorted the identity buffer stands in for
+ *  their order, so it's grown first if the layer is larger than it.
+ *  The next upload rebinds the streaming buffers.
+ *
+ *  @param[in] layer The layer to render, its data must be up to date.
+ *  @param[in] state The render state to draw the layer with.
+ *  @return The number of draw calls issued.
+ */
+int ASGE::GLModernSpriteRenderer::render(const GLStaticSpriteLayer& layer, RenderState* state)
+{
+  if (layer.getBatches().empty())
+  {
+    return 0;
+  }
 
-  /// rebind the range used in the SSBO bind
   glBindBufferRange(
     GL_SHADER_STORAGE_BUFFER,
     GLRenderConstants::QUAD_DATA_SSBO_BIND,
-    SSBO,
-    SSBOSize() * buffer_idx,
-    QUAD_STORAGE_SIZE * uploaded);
+    layer.getBuffer(),
+    0,
+    layer.getBufferSize());
+
+  reserveQuadIndices(static_cast<GLuint>(layer.size()));
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GLRenderConstants::QUAD_ORDER_SSBO_BIND, instance_buffer);
+  return submit(layer.getBatches(), state);
+}
+
+/**
+ *  Streams the sorted order of a range of quads into its ring.
+ *  The quads themselves were written into the mapped SSBO by the
+ *  sprite batch when they were submitted, so only their indices are
+ *  written here. The shader reads each quad through this order.
+ *
+ *  @param[in] range The quads to upload, the end is inclusive.
+ *  @param[in] payloads Unused, the quads are already on the GPU.
+ *  @return The last quad that was uploaded.
+ */
+ASGE::QuadIter
+ASGE::GLModernSpriteRenderer::upload(const ASGE::QuadRange& range, const GPUQuadList& /*payloads*/)
+{
+  const auto requested = static_cast<GLuint>(std::distance(range.begin, range.end) + 1);
+  const auto count     = std::min(requested, SSBO_current_limit);
+  if (count != requested)
+  {
+    Logging::DEBUG("Reached SSBO Limit");
+  }
+
+  frame_quads += count;
+  const auto offset = reserve(order_ring, count);
+  auto* order       = mapped_order + offset;
+  auto cpu_quad     = range.begin;
+  for (GLuint i = 0; i < count; ++i, ++cpu_quad)
+  {
+    order[i] = cpu_quad->payload_idx | (GLuint{ cpu_quad->slot } << GLRenderConstants::QUAD_ORDER_SLOT_SHIFT);
+  }
+
+  /// rebind the whole quad buffer, a layer may have replaced it
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GLRenderConstants::QUAD_DATA_SSBO_BIND, SSBO);
+  glBindBufferRange(
+    GL_SHADER_STORAGE_BUFFER,
+    GLRenderConstants::QUAD_ORDER_SSBO_BIND,
+    order_buffer,
+    static_cast<GLintptr>(offset) * static_cast<GLintptr>(sizeof(GLuint)),
+    static_cast<GLsizeiptr>(count) * static_cast<GLsizeiptr>(sizeof(GLuint)));
 
-  return std::prev(range.begin + uploaded);
+  return std::prev(range.begin + count);
 }
 
 ASGE::GLRenderer::RenderLib ASGE::GLModernSpriteRenderer::getRenderLib() const
@@ -14,10 +14,13 @@
 #include "CGLSpriteRenderer.hpp"
 #include "GLIncludes.hpp"
 #include "GLQuad.hpp"
+#include "GLComputeCuller.hpp"
 #include "GLRenderBatch.hpp"
+#include "GLRingAllocator.hpp"
 #include "GLShader.hpp"
 #include "Texture.hpp"
 #include <future>
+#include <memory>
 #include <vector>
 
 namespace ASGE
@@ -45,25 +48,72 @@ namespace ASGE
     GLModernSpriteRenderer operator=(const GLModernSpriteRenderer&) = delete;
 
     bool init() override;
-    int render(std::vector<AnotherRenderBatch>&& batches) override;
-    QuadIter upload(const QuadRange& range) override;
+    int render(RenderBatches&& batches) override;
+    int render(const GLStaticSpriteLayer& layer, RenderState* state) override;
+    Renderer::RenderStats endFrame() override;
+    [[nodiscard]] GPUQuad* mappedQuads() noexcept override;
+    std::optional<GLuint> reserveQuads(GLuint count, bool drawn) override;
+    void setGpuCulling(bool enabled) override;
+    [[nodiscard]] GLuint quadCapacity() const noexcept override;
+    QuadIter upload(const QuadRange& range, const GPUQuadList& payloads) override;
     [[nodiscard]] GLRenderer::RenderLib getRenderLib() const override;
 
    private:
+    /**
+     * The layout glMultiDrawElementsIndirect expects for each draw.
+     */
+    struct DrawElementsIndirectCommand
+    {
+      GLuint count          = 0;
+      GLuint instance_count = 0;
+      GLuint first_index    = 0;
+      GLint  base_vertex    = 0;
+      GLuint base_instance  = 0;
+    };
+
+    static_assert(
+      sizeof(DrawElementsIndirectCommand) == GLComputeCuller::COMMAND_SIZE,
+      "The culler writes commands with a different layout");
+
+    static constexpr GLsizeiptr IndirectSize() noexcept;
+    void allocateQuadBuffers(GLuint capacity);
+    void reserveQuadIndices(GLuint count);
+    void resizeQuadBuffers();
+    int submit(const RenderBatches& batches, RenderState* state_override);
+    int submitCulled(const RenderBatches& batches);
+    GLuint reserve(GLRingAllocator& ring, GLuint count);
 
-    static constexpr GLsizei SSBOSize() noexcept;
     GLuint  SSBO = 0;
-		GLuint  SSBO_current_limit = ASGE::GLRenderConstants::MAX_BATCH_COUNT;
+		GLuint  SSBO_current_limit = 0;
+    GLuint  element_buffer  = 0;
+    GLuint  instance_buffer = 0;
+    GLuint  quad_index_count = 0;
+    GLuint  indirect_buffer = 0;
+    GLuint  order_buffer    = 0;
 
-		// Triple buffered objects, speeds up AMD/NVIDIA???
-    // https://www.khronos.org/opengl/wiki/Vertex_Specification_Best_Practices
-    unsigned short buffer_idx = 0;
-    struct VBOTripleBuffer
-    {
-      constexpr static int BUFFER_COUNT        = 3;
-      std::array<void *, BUFFER_COUNT> buffers = {nullptr};
-      std::array<GLsync, BUFFER_COUNT> syncs   = { nullptr};
-    };
-    VBOTripleBuffer triple_buffer;
+    // the quads, their sorted order and the draw commands are streamed
+    // through persistently mapped rings, which are fenced once per frame
+    // rather than per flush. quads are written by the sprite batch itself
+    static constexpr GLuint FRAMES_IN_FLIGHT = 3;
+    GPUQuad* mapped_quads = nullptr;
+    GLuint* mapped_order  = nullptr;
+    DrawElementsIndirectCommand* mapped_commands = nullptr;
+    GLRingAllocator quad_ring;
+    GLRingAllocator order_ring;
+    GLRingAllocator command_ring;
+
+    // the quad rings start small and are resized between frames to
+    // follow demand, within the budget set by the game settings
+    static constexpr GLuint MIN_QUAD_CAPACITY   = 16384;
+    static constexpr GLuint SHRINK_AFTER_FRAMES = 600;
+    GLuint quad_capacity    = 0;
+    GLuint frame_quads      = 0;
+    GLuint high_water       = 0;
+    GLuint low_usage_frames = 0;
+
+    // when set, streamed quads are culled in a compute pass before drawing
+    std::unique_ptr<GLComputeCuller> culler;
+    std::vector<GLComputeCuller::Group> cull_groups;
+    std::vector<RenderBatches::const_iterator> cull_group_batches;
   };
 }  // namespace ASGE
@@ -12,7 +12,9 @@
 
 #include "GLPixelBuffer.hpp"
 #include "GLFormat.hpp"
+#include "GLStateCache.hpp"
 #include "GLTexture.hpp"
+#include "Logger.hpp"
 #include <cstring>
 #include <math.h>
 
@@ -25,9 +27,23 @@ ASGE::GLPixelBuffer::GLPixelBuffer(const GLTexture& texture)
     texture_id(texture.getID()),
     pixels(new GLubyte[inBytes(0)])
 {
+  const auto& region = texture.getAtlasRegion();
+  if (region.page != nullptr)
+  {
+    packed      = true;
+    region_x    = static_cast<GLint>(region.x);
+    region_y    = static_cast<GLint>(region.y);
+    page_width  = static_cast<GLuint>(region.page->getWidth());
+    page_height = static_cast<GLuint>(region.page->getHeight());
+  }
+
+  // without DSA the whole page is read back, so the PBO must fit it
+  const auto pbo_size =
+    packed && !GLTexture::useDSA() ? page_width * page_height * format : inBytes(0);
+
   GLVMSG(__PRETTY_FUNCTION__, glGenBuffers, 1, &pbo_read_id);
   glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_read_id);
-  glBufferData(GL_PIXEL_PACK_BUFFER, inBytes(0), nullptr, GL_STREAM_READ);
+  glBufferData(GL_PIXEL_PACK_BUFFER, pbo_size, nullptr, GL_STREAM_READ);
   ASGE::GLPixelBuffer::download(0);
 }
 
@@ -36,7 +52,12 @@ ASGE::GLPixelBuffer::GLPixelBuffer(ASGE::GLPixelBuffer&& rhs) noexcept
     pbo_read_id(std::exchange(rhs.pbo_read_id, 0)),
     format(rhs.format),
     texture_id(std::exchange(rhs.texture_id, 0)),
-    pixels(std::move(rhs.pixels))
+    pixels(std::move(rhs.pixels)),
+    packed(rhs.packed),
+    region_x(rhs.region_x),
+    region_y(rhs.region_y),
+    page_width(rhs.page_width),
+    page_height(rhs.page_height)
 {
 }
 
@@ -45,12 +66,62 @@ ASGE::GLPixelBuffer::~GLPixelBuffer()
   glDeleteBuffers(1, &pbo_read_id);
 }
 
+/**
+ *  Copies the texels back into the texture.
+ *  A packed texture is written into its region of the page, after
+ *  which the page's mips are rebuilt. Its gutter keeps the texels it
+ *  was packed with.
+ *
+ *  @param mip_level The level to write, packed textures only have 0.
+ */
 void ASGE::GLPixelBuffer::upload(unsigned int mip_level) noexcept
 {
-  int idx = 0;
-  glGetIntegerv(GL_TEXTURE_BINDING_2D, &idx);
+  if (isPackedMip(mip_level))
+  {
+    return;
+  }
+
+  if (packed)
+  {
+    const auto width  = static_cast<GLsizei>(getWidth());
+    const auto height = static_cast<GLsizei>(getHeight());
+    if (GLTexture::useDSA())
+    {
+      glTextureSubImage2D(
+        texture_id, 0, region_x, region_y, width, height, GLFORMAT[format], GL_UNSIGNED_BYTE, pixels.get());
+      glGenerateTextureMipmap(texture_id);
+      return;
+    }
 
-  glBindTexture(GL_TEXTURE_2D, texture_id);
+    GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, texture_id);
+    glTexSubImage2D(
+      GL_TEXTURE_2D, 0, region_x, region_y, width, height, GLFORMAT[format], GL_UNSIGNED_BYTE, pixels.get());
+    glGenerateMipmap(GL_TEXTURE_2D);
+    return;
+  }
+
+  // the storage is immutable, so the level is overwritten in place
+  if (GLTexture::useDSA())
+  {
+    glTextureSubImage2D(
+      texture_id,
+      static_cast<GLint>(mip_level),
+      0,
+      0,
+      static_cast<GLsizei>(getMipWidth(mip_level)),
+      static_cast<GLsizei>(getMipHeight(mip_level)),
+      GLFORMAT[format],
+      GL_UNSIGNED_BYTE,
+      pixels.get());
+
+    if (mip_level == 0)
+    {
+      glGenerateTextureMipmap(texture_id);
+    }
+    return;
+  }
+
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, texture_id);
   glTexImage2D(GL_TEXTURE_2D,
                mip_level,
                GL_RGBA,
@@ -65,8 +136,6 @@ void ASGE::GLPixelBuffer::upload(unsigned int mip_level) noexcept
   {
     glGenerateMipmap(GL_TEXTURE_2D);
   }
-
-  glBindTexture(GL_TEXTURE_2D, idx);
 }
 
 void ASGE::GLPixelBuffer::upload(std::byte* data, unsigned int mip_level) noexcept
@@ -75,10 +144,61 @@ void ASGE::GLPixelBuffer::upload(std::byte* data, unsigned int mip_level) noexce
   upload(mip_level);
 }
 
+/**
+ *  Starts reading the texture's texels back into the PBO.
+ *  A packed texture reads its region of the page. Without DSA there's
+ *  no way to read part of a texture, so the whole page is read and
+ *  the region is picked out when the pixels are mapped.
+ *
+ *  @param mip_level The level to read, packed textures only have 0.
+ */
 void ASGE::GLPixelBuffer::download(unsigned int mip_level) noexcept
 {
+  if (isPackedMip(mip_level))
+  {
+    return;
+  }
+
   glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo_read_id);
-  glBindTexture(GL_TEXTURE_2D, texture_id);
+  if (packed && GLTexture::useDSA())
+  {
+    GLVMSG(
+      __PRETTY_FUNCTION__,
+      glGetTextureSubImage,
+      texture_id,
+      0,
+      region_x,
+      region_y,
+      0,
+      static_cast<GLsizei>(getWidth()),
+      static_cast<GLsizei>(getHeight()),
+      1,
+      GLFORMAT[format],
+      GL_UNSIGNED_BYTE,
+      static_cast<GLsizei>(inBytes(0)),
+      nullptr);
+
+    stale = true;
+    return;
+  }
+
+  if (GLTexture::useDSA())
+  {
+    GLVMSG(
+      __PRETTY_FUNCTION__,
+      glGetTextureImage,
+      texture_id,
+      static_cast<GLint>(mip_level),
+      GLFORMAT[format],
+      GL_UNSIGNED_BYTE,
+      static_cast<GLsizei>(inBytes(mip_level)),
+      nullptr);
+
+    stale = true;
+    return;
+  }
+
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, texture_id);
 
   // transfer texture into PBO
   GLVMSG(
@@ -106,7 +226,22 @@ const std::byte* ASGE::GLPixelBuffer::getPixelData() const noexcept
   if(isBufferStale())
   {
     auto *gpu_data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-    memcpy(pixels.get(), gpu_data, inBytes(0));
+    if (packed && !GLTexture::useDSA())
+    {
+      // the PBO holds the whole page, so copy out the region's rows
+      const auto row_bytes = getWidth() * format;
+      const auto* page     = static_cast<const GLubyte*>(gpu_data);
+      for (unsigned int row = 0; row < getHeight(); ++row)
+      {
+        const auto page_row = static_cast<GLuint>(region_y) + row;
+        const auto offset   = (page_row * page_width + static_cast<GLuint>(region_x)) * format;
+        memcpy(pixels.get() + row * row_bytes, page + offset, row_bytes);
+      }
+    }
+    else
+    {
+      memcpy(pixels.get(), gpu_data, inBytes(0));
+    }
     glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
     stale = false;
   }
@@ -135,6 +270,24 @@ std::uint32_t ASGE::GLPixelBuffer::getMipHeight(uint32_t mip_level) const noexce
     mip_level == 0 ? getHeight() : getHeight() / pow(2, mip_level));
 }
 
+/**
+ *  Packed textures share the page's mips, so only their base level
+ *  can be transferred.
+ *
+ *  @param mip_level The level being transferred.
+ *  @return True if the level can't be transferred.
+ */
+bool ASGE::GLPixelBuffer::isPackedMip(uint32_t mip_level) const noexcept
+{
+  if (packed && mip_level != 0)
+  {
+    Logging::WARN("Only the base level of an atlas packed texture can be transferred");
+    return true;
+  }
+
+  return false;
+}
+
 std::uint32_t ASGE::GLPixelBuffer::pixelFormat() const noexcept
 {
   return format;
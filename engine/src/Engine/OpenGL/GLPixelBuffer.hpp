@@ -24,6 +24,12 @@ namespace ASGE
 
 namespace ASGE
 {
+  /**
+   * A CPU copy of a texture's texels, transferred through a PBO.
+   * Textures packed into an atlas page only read and write their own
+   * region of the page, and only at the base level, as the page's
+   * mips are shared and regenerated as a whole.
+   */
   class GLPixelBuffer : public ASGE::PixelBuffer
   {
    public:
@@ -46,12 +52,20 @@ namespace ASGE
     std::uint32_t inBytes(uint32_t mip_level) const noexcept;
     std::uint32_t getMipWidth(uint32_t mip_level) const noexcept;
     std::uint32_t getMipHeight(uint32_t mip_level) const noexcept;
+    bool isPackedMip(uint32_t mip_level) const noexcept;
 
    private:
     GLuint pbo_read_id;
     GLuint format;
     GLuint texture_id;
     std::unique_ptr<GLubyte[]> pixels;
+
+    // the texture's offset into its atlas page, if it's been packed
+    bool packed         = false;
+    GLint region_x      = 0;
+    GLint region_y      = 0;
+    GLuint page_width   = 0;
+    GLuint page_height  = 0;
   };
 }
 
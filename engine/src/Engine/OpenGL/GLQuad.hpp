@@ -13,7 +13,7 @@
 #ifndef ASGE_GLQUAD_H
 #define ASGE_GLQUAD_H
 
-#include <array>
+#include <type_traits>
 #include "GLConstants.hpp"
 #include "GLIncludes.hpp"
 
@@ -21,72 +21,60 @@ namespace ASGE
 {
   /**
    * A GPUQuad is the data the GPU requires in order to render a texture to the
-   * screen. It consists of the transform data (matrix), colour and UV data.
-   * These quads are directly copied from CPU to GPU memory when batches
-   * are uploaded.
+   * screen. Only the 2x2 linear part of the transform is stored along with the
+   * translation, the texture's UV rect and a packed RGBA8 colour. The corners
+   * of the quad are generated in the vertex shader from gl_VertexID. These
+   * quads are directly copied from CPU to GPU memory when batches are uploaded.
    */
   struct GPUQuad
   {
-    GPUQuad() = default;
-    GPUQuad(const GPUQuad&);
-    GPUQuad& operator=(const GPUQuad&);
-    GPUQuad& operator=(GPUQuad&&) noexcept;
-    GPUQuad(GPUQuad&&) noexcept;
-    ~GPUQuad() = default;
-
-    glm::mat4 position = glm::mat4{ 1 };
-    static constexpr const glm::vec2 PADDING{ 5, 5 };
-    glm::vec4 color = glm::vec4{ 1, 1, 1, 1 };
-    std::array<glm::vec4, GLRenderConstants::VERTEX_PER_QUAD> uv_data = {
-      glm::vec4{ 0.0F, 1.0F, PADDING },
-      glm::vec4{ 0.0F, 0.0F, PADDING },
-      glm::vec4{ 1.0F, 0.0F, PADDING },
-      glm::vec4{ 1.0F, 1.0F, PADDING }
-    };
+    glm::vec4 transform   = glm::vec4{ 1, 0, 0, 1 }; // column major 2x2
+    glm::vec4 uv_rect     = glm::vec4{ 0, 0, 1, 1 }; // u0, v0, u1, v1
+    glm::vec2 translation = glm::vec2{ 0, 0 };
+    GLuint colour         = 0xFFFFFFFF;              // RGBA8, red in the low byte
+    GLshort z_order       = 0;
+    GLushort slot         = 0;                       // texture slot, for quads read without a sorted order
   };
 
   static constexpr GLsizei QUAD_STORAGE_SIZE = sizeof(GPUQuad);
+  static_assert(std::is_trivially_copyable_v<GPUQuad>, "GPUQuads must be trivially copyable");
+  static_assert(QUAD_STORAGE_SIZE == 48, "GPUQuad no longer matches the shader's Quad struct");
 
   static_assert(
     (GLRenderConstants::MAX_BATCH_COUNT * QUAD_STORAGE_SIZE) % 64 == 0,
     "BATCH COUNT IS NOT DIVISIBLE BY 64. BUFFER RANGES CAN NOT MAP!");
 
-  //  base alignment    // aligned offset
-  //  float value;      // 4               // 0
-  //  vec3 vector;      // 16              // 16  (must be multiple of 16 so 4->16)
-  //  mat4 matrix;      // 16              // 32  (column 0)
-  //  // 16             // 48  (column 1)
-  //  // 16             // 64  (column 2)
-  //  // 16             // 80  (column 3)
-  //  float values[3];  // 16              // 96  (values[0])
-  //  // 16             // 112 (values[1])
-  //  // 16             // 128 (values[2])
-  //  bool boolean;     // 4               // 144
-  //  int integer;      // 4               // 148
-
-  //  std::array<glm::vec4, GLRenderConstants::VERTEX_PER_QUAD> uv_data =
-  //    { glm::vec4{ 0.0f, 1.0f, padding_t}, glm::vec4{ 0.0f, 0.0f, padding_t },
-  //      glm::vec4{ 1.0f, 0.0f, padding_t}, glm::vec4{ 1.0f, 0.0f, padding_t },
-  //      glm::vec4{ 1.0f, 1.0f, padding_t}, glm::vec4{ 0.0f, 1.0f, padding_t } };
+  //  base alignment        // aligned offset
+  //  vec4 transform;       // 16              // 0
+  //  vec4 uv_rect;         // 16              // 16
+  //  vec2 translation;     // 8               // 32
+  //  uint colour;          // 4               // 40
+  //  uint depth_slot;      // 4               // 44 (z-order low, slot high)
+  //                                           // 48 (std140 & std430 stride)
 
   class RenderState;
+
+  /**
+   * A RenderQuad holds the fields needed to sort and batch a quad.
+   * The GPU data lives in a separate payload array and is referenced
+   * by index, so sorting and batch generation only touch this compact
+   * metadata. The payload is gathered in sorted order during upload.
+   */
   struct RenderQuad
   {
-    RenderQuad() = default;
-    RenderQuad(const RenderQuad&);
-    RenderQuad& operator=(const RenderQuad&);
-    RenderQuad(RenderQuad&&) noexcept;
-    RenderQuad& operator=(RenderQuad&&) noexcept;
-    ~RenderQuad() = default;
-
-    GPUQuad gpu_data {};
-    GLuint  shader_id  = 0;
-    GLuint  texture_id = 0;
-    GLshort z_order    = 0;
-    GLfloat distance   = 0;
-    RenderState* state = nullptr;
+    RenderState* state  = nullptr;
+    GLuint  shader_id   = 0;
+    GLuint  texture_id  = 0;
+    GLuint  payload_idx = 0;
+    GLfloat distance    = 0;
+    GLshort z_order     = 0;
+    GLushort layer_idx  = 0; // 1-based index of a retained layer, 0 for a quad
+    GLuint  group       = 0; // the texture group, see GLSpriteBatch::assignTextureSlots
+    GLushort slot       = 0; // the quad's texture within its group
   };
 
+  static_assert(std::is_trivially_copyable_v<RenderQuad>, "RenderQuads must be trivially copyable");
+
   enum BufferState : unsigned int
   {
     UPLOAD_OKAY,
@@ -0,0 +1,165 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLQuadSort.hpp"
+#include "GLWorkerPool.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace
+{
+  constexpr int RADIX_BITS    = 8;
+  constexpr int RADIX_BUCKETS = 1 << RADIX_BITS;
+  constexpr int KEY_BYTES     = sizeof(std::uint64_t);
+
+  /// below this the overhead of the histograms outweighs the gains
+  constexpr std::size_t MIN_RADIX_SORT_SIZE = 64;
+
+  /// below this a single thread is quicker than synchronising workers
+  constexpr std::size_t MIN_KEYS_PER_WORKER = 1U << 16U;
+
+  /// the histograms live on the stack, which bounds the workers used
+  constexpr std::size_t MAX_SORT_WORKERS = 16;
+
+  using Histogram = std::array<std::size_t, RADIX_BUCKETS>;
+
+  inline std::size_t digit(std::uint64_t key, int shift) noexcept
+  {
+    return static_cast<std::size_t>((key >> shift) & (RADIX_BUCKETS - 1));
+  }
+
+  /// a single stable counting sort pass on the digit at shift
+  void scatterPass(
+    const std::vector<ASGE::QuadSortKey>& src, std::vector<ASGE::QuadSortKey>& dst, int shift)
+  {
+    Histogram offsets{};
+    for (const auto& record : src)
+    {
+      ++offsets[digit(record.key, shift)];
+    }
+
+    std::size_t total = 0;
+    for (auto& offset : offsets)
+    {
+      total += std::exchange(offset, total);
+    }
+
+    for (const auto& record : src)
+    {
+      dst[offsets[digit(record.key, shift)]++] = record;
+    }
+  }
+
+  /// the same pass, but each worker histograms and scatters its own chunk
+  void scatterPassThreaded(
+    const std::vector<ASGE::QuadSortKey>& src, std::vector<ASGE::QuadSortKey>& dst,
+    int shift, std::size_t workers, ASGE::GLWorkerPool& pool)
+  {
+    const std::size_t count = src.size();
+    const std::size_t chunk = (count + workers - 1) / workers;
+    std::array<Histogram, MAX_SORT_WORKERS> offsets{};
+
+    auto histogram_chunk = [&](std::size_t w) {
+      const auto end = std::min(count, (w + 1) * chunk);
+      for (auto i = w * chunk; i < end; ++i)
+      {
+        ++offsets[w][digit(src[i].key, shift)];
+      }
+    };
+    pool.forEach(workers, histogram_chunk);
+
+    // bucket major, worker minor prefix sum keeps the sort stable
+    std::size_t total = 0;
+    for (std::size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket)
+    {
+      for (std::size_t w = 0; w < workers; ++w)
+      {
+        total += std::exchange(offsets[w][bucket], total);
+      }
+    }
+
+    auto scatter_chunk = [&](std::size_t w) {
+      auto& histogram = offsets[w];
+      const auto end  = std::min(count, (w + 1) * chunk);
+      for (auto i = w * chunk; i < end; ++i)
+      {
+        dst[histogram[digit(src[i].key, shift)]++] = src[i];
+      }
+    };
+    pool.forEach(workers, scatter_chunk);
+  }
+}  // namespace
+
+std::uint64_t ASGE::packQuadSortKey(
+  SpriteSortMode mode, std::int16_t z_order, std::uint32_t texture_id) noexcept
+{
+  if (mode == SpriteSortMode::TEXTURE)
+  {
+    return texture_id;
+  }
+
+  // flip the sign bit so that negative z-orders are ordered first
+  auto z_key = static_cast<std::uint16_t>(static_cast<std::uint16_t>(z_order) ^ 0x8000U);
+  if (mode != SpriteSortMode::BACK_TO_FRONT)
+  {
+    z_key = static_cast<std::uint16_t>(~z_key);
+  }
+
+  return (static_cast<std::uint64_t>(z_key) << 32U) | texture_id;
+}
+
+void ASGE::radixSortQuadKeys(
+  std::vector<QuadSortKey>& keys, std::vector<QuadSortKey>& scratch, GLWorkerPool* workers)
+{
+  if (keys.size() < MIN_RADIX_SORT_SIZE)
+  {
+    std::stable_sort(
+      keys.begin(), keys.end(),
+      [](const QuadSortKey& lhs, const QuadSortKey& rhs) { return lhs.key < rhs.key; });
+    return;
+  }
+
+  // find out which bytes actually differ, the rest can be skipped
+  std::uint64_t varying = 0;
+  for (const auto& record : keys)
+  {
+    varying |= record.key ^ keys.front().key;
+  }
+
+  const std::size_t threads =
+    workers == nullptr
+      ? 1
+      : std::clamp<std::size_t>(
+          keys.size() / MIN_KEYS_PER_WORKER, 1, std::min<std::size_t>(workers->size(), MAX_SORT_WORKERS));
+
+  scratch.resize(keys.size());
+  for (int byte = 0; byte < KEY_BYTES; ++byte)
+  {
+    const int shift = byte * RADIX_BITS;
+    if (digit(varying, shift) == 0)
+    {
+      continue;
+    }
+
+    if (threads > 1)
+    {
+      scatterPassThreaded(keys, scratch, shift, threads, *workers);
+    }
+    else
+    {
+      scatterPass(keys, scratch, shift);
+    }
+
+    keys.swap(scratch);
+  }
+}
@@ -0,0 +1,66 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#ifndef ASGE_GLQUADSORT_HPP
+#define ASGE_GLQUADSORT_HPP
+
+#include "Texture.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace ASGE
+{
+  class GLWorkerPool;
+
+  /**
+   * A sort key and the index of the quad it was generated from.
+   * Sorting these small records instead of the quads themselves
+   * means each pass only has to move 16 bytes per quad.
+   */
+  struct QuadSortKey
+  {
+    std::uint64_t key   = 0;
+    std::uint32_t index = 0;
+    std::uint32_t padding = 0;
+  };
+
+  static_assert(sizeof(QuadSortKey) == 16, "QuadSortKey is expected to be 16 bytes");
+
+  /**
+   * Packs the fields used to order a quad into a single key.
+   * Comparing two keys produces the same ordering as the sprite
+   * sort mode would when comparing the quads field by field.
+   *
+   * @param mode The sort mode in use.
+   * @param z_order The quad's z-order.
+   * @param texture_id The quad's texture.
+   * @return The packed key.
+   */
+  [[nodiscard]] std::uint64_t
+  packQuadSortKey(SpriteSortMode mode, std::int16_t z_order, std::uint32_t texture_id) noexcept;
+
+  /**
+   * Stable LSD radix sort on the packed keys.
+   * Only the bytes that differ between the keys are sorted on, which
+   * for typical scenes is just a handful of passes. Large lists can
+   * have their histogram and scatter passes split across workers.
+   *
+   * @param[in,out] keys The keys to sort.
+   * @param[in,out] scratch Scratch storage, resized as needed.
+   * @param[in] workers The workers to split large lists across, if any.
+   */
+  void radixSortQuadKeys(
+    std::vector<QuadSortKey>& keys, std::vector<QuadSortKey>& scratch,
+    GLWorkerPool* workers = nullptr);
+}  // namespace ASGE
+
+#endif // ASGE_GLQUADSORT_HPP
@@ -0,0 +1,213 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "GLQuadTransform.hpp"
+#include "GLTexture.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#  define ASGE_QUAD_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define ASGE_QUAD_SIMD_WIDTH 4
+#endif
+
+// keeps the compiler from fusing the scalar or vector multiplies
+// into FMAs, which would break the paths' bit compatibility. The
+// build also disables contraction for this file, for compilers
+// that ignore the pragma.
+#if defined(__clang__)
+#  pragma clang fp contract(off)
+#elif defined(_MSC_VER)
+#  pragma fp_contract(off)
+#endif
+
+namespace
+{
+  /// the shared closed form, given the rotation's cosine and sine
+  void writeQuad(
+    float x, float y, float width, float height, float cos_r, float sin_r, float src_x,
+    float src_y, float src_width, float src_height, float offset_x, float offset_y,
+    float inv_width, float inv_height, ASGE::GPUQuad& quad) noexcept
+  {
+    const auto centre_x = 0.5F * width;
+    const auto centre_y = 0.5F * height;
+
+    quad.transform = glm::vec4{ cos_r * width, sin_r * width, -sin_r * height, cos_r * height };
+
+    const auto rotated_x = cos_r * centre_x - sin_r * centre_y;
+    const auto rotated_y = sin_r * centre_x + cos_r * centre_y;
+    quad.translation     = glm::vec2{ (x + centre_x) - rotated_x, (y + centre_y) - rotated_y };
+
+    const auto u0  = offset_x + src_x;
+    const auto v0  = offset_y + src_y;
+    quad.uv_rect = glm::vec4{
+      u0 * inv_width, v0 * inv_height, (u0 + src_width) * inv_width, (v0 + src_height) * inv_height
+    };
+  }
+
+#ifdef ASGE_QUAD_SIMD_WIDTH
+  constexpr std::size_t SIMD_WIDTH = ASGE_QUAD_SIMD_WIDTH;
+
+#  if ASGE_QUAD_SIMD_WIDTH == 8
+  using Vec = __m256;
+  inline Vec load(const float* src) noexcept { return _mm256_load_ps(src); }
+  inline void store(float* dst, Vec v) noexcept { _mm256_store_ps(dst, v); }
+  inline Vec splat(float value) noexcept { return _mm256_set1_ps(value); }
+  inline Vec add(Vec a, Vec b) noexcept { return _mm256_add_ps(a, b); }
+  inline Vec sub(Vec a, Vec b) noexcept { return _mm256_sub_ps(a, b); }
+  inline Vec mul(Vec a, Vec b) noexcept { return _mm256_mul_ps(a, b); }
+  inline Vec negate(Vec a) noexcept { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0F)); }
+#  else
+  using Vec = __m128;
+  inline Vec load(const float* src) noexcept { return _mm_load_ps(src); }
+  inline void store(float* dst, Vec v) noexcept { _mm_store_ps(dst, v); }
+  inline Vec splat(float value) noexcept { return _mm_set1_ps(value); }
+  inline Vec add(Vec a, Vec b) noexcept { return _mm_add_ps(a, b); }
+  inline Vec sub(Vec a, Vec b) noexcept { return _mm_sub_ps(a, b); }
+  inline Vec mul(Vec a, Vec b) noexcept { return _mm_mul_ps(a, b); }
+  inline Vec negate(Vec a) noexcept { return _mm_xor_ps(a, _mm_set1_ps(-0.0F)); }
+#  endif
+
+  /// the vector results, stored per component before being scattered
+  struct QuadLanes
+  {
+    alignas(32) ASGE::QuadBlock::Lanes transform[4]{};
+    alignas(32) ASGE::QuadBlock::Lanes translation[2]{};
+    alignas(32) ASGE::QuadBlock::Lanes uv_rect[4]{};
+  };
+
+  /// the same operations as writeQuad, in the same order
+  void transformLanes(
+    const ASGE::QuadBlock& block, const ASGE::QuadBlock::Lanes& cos_lanes,
+    const ASGE::QuadBlock::Lanes& sin_lanes, std::size_t lane, QuadLanes& out) noexcept
+  {
+    const auto width  = load(&block.width[lane]);
+    const auto height = load(&block.height[lane]);
+    const auto cos_r  = load(&cos_lanes[lane]);
+    const auto sin_r  = load(&sin_lanes[lane]);
+    const auto half   = splat(0.5F);
+
+    const auto centre_x = mul(half, width);
+    const auto centre_y = mul(half, height);
+
+    store(&out.transform[0][lane], mul(cos_r, width));
+    store(&out.transform[1][lane], mul(sin_r, width));
+    store(&out.transform[2][lane], mul(negate(sin_r), height));
+    store(&out.transform[3][lane], mul(cos_r, height));
+
+    const auto rotated_x = sub(mul(cos_r, centre_x), mul(sin_r, centre_y));
+    const auto rotated_y = add(mul(sin_r, centre_x), mul(cos_r, centre_y));
+    store(&out.translation[0][lane], sub(add(load(&block.x[lane]), centre_x), rotated_x));
+    store(&out.translation[1][lane], sub(add(load(&block.y[lane]), centre_y), rotated_y));
+
+    const auto inv_width  = load(&block.inv_width[lane]);
+    const auto inv_height = load(&block.inv_height[lane]);
+    const auto u0 = add(load(&block.offset_x[lane]), load(&block.src_x[lane]));
+    const auto v0 = add(load(&block.offset_y[lane]), load(&block.src_y[lane]));
+    store(&out.uv_rect[0][lane], mul(u0, inv_width));
+    store(&out.uv_rect[1][lane], mul(v0, inv_height));
+    store(&out.uv_rect[2][lane], mul(add(u0, load(&block.src_width[lane])), inv_width));
+    store(&out.uv_rect[3][lane], mul(add(v0, load(&block.src_height[lane])), inv_height));
+  }
+#endif
+}  // namespace
+
+GLuint ASGE::packColour(float r, float g, float b, float a) noexcept
+{
+  auto to_byte = [](float channel) {
+    return static_cast<GLuint>(std::clamp(channel, 0.0F, 1.0F) * 255.0F + 0.5F);
+  };
+
+  return to_byte(r) | (to_byte(g) << 8U) | (to_byte(b) << 16U) | (to_byte(a) << 24U);
+}
+
+ASGE::UvMapping ASGE::uvMapping(const GLTexture& texture) noexcept
+{
+  const auto& region  = texture.getAtlasRegion();
+  const auto* sampled = region.page != nullptr ? region.page : &texture;
+  return UvMapping{ region.x, region.y, 1.0F / sampled->getWidth(), 1.0F / sampled->getHeight() };
+}
+
+void ASGE::QuadBlock::set(
+  std::size_t lane, float quad_x, float quad_y, float quad_width, float quad_height,
+  float quad_rotation, const float* src_rect, const UvMapping& mapping) noexcept
+{
+  x[lane]          = quad_x;
+  y[lane]          = quad_y;
+  width[lane]      = quad_width;
+  height[lane]     = quad_height;
+  rotation[lane]   = quad_rotation;
+  src_x[lane]      = src_rect[0];
+  src_y[lane]      = src_rect[1];
+  src_width[lane]  = src_rect[2];
+  src_height[lane] = src_rect[3];
+  offset_x[lane]   = mapping.offset_x;
+  offset_y[lane]   = mapping.offset_y;
+  inv_width[lane]  = mapping.inv_width;
+  inv_height[lane] = mapping.inv_height;
+}
+
+void ASGE::transformQuad(
+  float x, float y, float width, float height, float rotation, const float* src_rect,
+  const UvMapping& mapping, GPUQuad& quad) noexcept
+{
+  writeQuad(
+    x, y, width, height, std::cos(rotation), std::sin(rotation), src_rect[0], src_rect[1],
+    src_rect[2], src_rect[3], mapping.offset_x, mapping.offset_y, mapping.inv_width,
+    mapping.inv_height, quad);
+}
+
+void ASGE::transformQuads(const QuadBlock& block, std::size_t count, GPUQuad* const* quads) noexcept
+{
+  count = std::min(count, QuadBlock::LANES);
+
+  alignas(32) QuadBlock::Lanes cos_r{};
+  alignas(32) QuadBlock::Lanes sin_r{};
+  for (std::size_t lane = 0; lane < count; ++lane)
+  {
+    cos_r[lane] = std::cos(block.rotation[lane]);
+    sin_r[lane] = std::sin(block.rotation[lane]);
+  }
+
+  std::size_t lane = 0;
+#ifdef ASGE_QUAD_SIMD_WIDTH
+  QuadLanes out;
+  for (; lane + SIMD_WIDTH <= count; lane += SIMD_WIDTH)
+  {
+    transformLanes(block, cos_r, sin_r, lane, out);
+  }
+
+  for (std::size_t i = 0; i < lane; ++i)
+  {
+    auto& quad       = *quads[i];
+    quad.transform   = glm::vec4{ out.transform[0][i], out.transform[1][i], out.transform[2][i],
+                                  out.transform[3][i] };
+    quad.translation = glm::vec2{ out.translation[0][i], out.translation[1][i] };
+    quad.uv_rect     = glm::vec4{ out.uv_rect[0][i], out.uv_rect[1][i], out.uv_rect[2][i],
+                                  out.uv_rect[3][i] };
+  }
+#endif
+
+  // whatever doesn't fill a vector is finished one quad at a time
+  for (; lane < count; ++lane)
+  {
+    writeQuad(
+      block.x[lane], block.y[lane], block.width[lane], block.height[lane], cos_r[lane],
+      sin_r[lane], block.src_x[lane], block.src_y[lane], block.src_width[lane],
+      block.src_height[lane], block.offset_x[lane], block.offset_y[lane], block.inv_width[lane],
+      block.inv_height[lane], *quads[lane]);
+  }
+}
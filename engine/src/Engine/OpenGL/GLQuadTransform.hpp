@@ -0,0 +1,115 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#ifndef ASGE_GLQUADTRANSFORM_HPP
+#define ASGE_GLQUADTRANSFORM_HPP
+
+#include "GLQuad.hpp"
+#include <array>
+#include <cstddef>
+
+namespace ASGE
+{
+  class GLTexture;
+
+  /**
+   * Converts a texture's texels to UVs. Textures packed into an
+   * atlas are offset into their page, and the page's dimensions are
+   * stored as reciprocals so each UV is a multiply, not a divide.
+   */
+  struct UvMapping
+  {
+    float offset_x   = 0.0F;
+    float offset_y   = 0.0F;
+    float inv_width  = 1.0F;
+    float inv_height = 1.0F;
+  };
+
+  /**
+   * The inputs of a block of quads, one lane per quad. Callers fill
+   * the lanes from wherever their quads are stored and the block is
+   * transformed in one go, several lanes at a time where SIMD is
+   * available.
+   */
+  struct QuadBlock
+  {
+    static constexpr std::size_t LANES = 8;
+    using Lanes                        = std::array<float, LANES>;
+
+    alignas(32) Lanes x{};
+    alignas(32) Lanes y{};
+    alignas(32) Lanes width{};
+    alignas(32) Lanes height{};
+    alignas(32) Lanes rotation{};
+    alignas(32) Lanes src_x{};
+    alignas(32) Lanes src_y{};
+    alignas(32) Lanes src_width{};
+    alignas(32) Lanes src_height{};
+    alignas(32) Lanes offset_x{};
+    alignas(32) Lanes offset_y{};
+    alignas(32) Lanes inv_width{};
+    alignas(32) Lanes inv_height{};
+
+    void set(
+      std::size_t lane, float quad_x, float quad_y, float quad_width, float quad_height,
+      float quad_rotation, const float* src_rect, const UvMapping& mapping) noexcept;
+  };
+
+  /**
+   * Packs a normalised colour into RGBA8, with red in the low byte.
+   *
+   * @return The packed colour.
+   */
+  [[nodiscard]] GLuint packColour(float r, float g, float b, float a) noexcept;
+
+  /**
+   * Builds the UV mapping for a texture.
+   *
+   * @param texture The texture being sampled.
+   * @return The offset and reciprocal dimensions of the sampled page.
+   */
+  [[nodiscard]] UvMapping uvMapping(const GLTexture& texture) noexcept;
+
+  /**
+   * Writes a single quad's transform, translation and UVs.
+   * The rotation occurs around the middle of the quad. This is the
+   * scalar reference for transformQuads, which produces identical
+   * results.
+   *
+   * @param x The left edge of the quad.
+   * @param y The top edge of the quad.
+   * @param width The scaled width of the quad.
+   * @param height The scaled height of the quad.
+   * @param rotation The rotation in radians.
+   * @param src_rect The x, y, width and height to sample, in texels.
+   * @param mapping The sampled texture's UV mapping.
+   * @param quad The quad to write to.
+   */
+  void transformQuad(
+    float x, float y, float width, float height, float rotation, const float* src_rect,
+    const UvMapping& mapping, GPUQuad& quad) noexcept;
+
+  /**
+   * Writes the transform, translation and UVs of a block of quads.
+   * Uses AVX or SSE when the build targets them, otherwise falls back
+   * to transformQuad. The trigonometry is always scalar so every path
+   * produces bit identical quads.
+   *
+   * @param block The inputs, one lane per quad.
+   * @param count The number of lanes in use.
+   * @param quads The quad each lane is written to.
+   */
+  void transformQuads(const QuadBlock& block, std::size_t count, GPUQuad* const* quads) noexcept;
+}  // namespace ASGE
+
+#endif // ASGE_GLQUADTRANSFORM_HPP
@@ -1,9 +1,13 @@
 #pragma once
+#include "GLConstants.hpp"
 #include "GLIncludes.hpp"
 #include "GLQuad.hpp"
 #include "Sprite.hpp"
+#include <algorithm>
+#include <array>
 #include <bitset>
 #include <list>
+#include <memory_resource>
 #include <variant>
 #include <vector>
 
@@ -41,6 +45,20 @@ namespace ASGE
     char ch               = ' ';
   };
 
+  /**
+   * The textures bound for a batch, indexed by each quad's slot.
+   */
+  struct TextureSlots
+  {
+    std::array<GLuint, GLRenderConstants::MAX_TEXTURE_SLOTS> ids{};
+    GLuint count = 0;
+
+    [[nodiscard]] bool operator==(const TextureSlots& rhs) const
+    {
+      return count == rhs.count && std::equal(ids.begin(), ids.begin() + count, rhs.ids.begin());
+    }
+  };
+
   /**
    *
    */
@@ -59,15 +77,16 @@ namespace ASGE
     GLuint start_idx      = 0;
     GLuint instance_count = 0;
     GLuint shader_id      = 0;
-    GLuint texture_id     = 0;
     GLuint distance       = 0;
+    TextureSlots textures = {};
     RenderState* state    = nullptr;
 
     std::bitset<REASON_COUNT> reason = I_DONT_KNOW;
   };
 
-  using RenderBatches = std::vector<AnotherRenderBatch>;
+  using RenderBatches = std::pmr::vector<AnotherRenderBatch>;
   using QuadList = std::vector<ASGE::RenderQuad>;
+  using GPUQuadList = std::vector<ASGE::GPUQuad>;
   using QuadIter = decltype(QuadList::const_iterator());
 
   /**
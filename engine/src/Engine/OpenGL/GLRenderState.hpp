@@ -13,6 +13,7 @@
 #ifndef PYASGE_GLRENDERSTATE_HPP
 #define PYASGE_GLRENDERSTATE_HPP
 
+#include "Camera.hpp"
 #include "GLIncludes.hpp"
 
 namespace ASGE
@@ -21,6 +22,16 @@ namespace ASGE
   {
     Viewport viewport {0,0,0,0};
     glm::mat4 projection;
+    Camera::CameraView view {};
+
+    // where the sprite renderer last uploaded the projection
+    GLintptr projection_offset = 0;
+    GLuint projection_epoch    = 0;
+
+    [[nodiscard]] bool operator==(const RenderState& rhs) const
+    {
+      return !(viewport != rhs.viewport) && projection == rhs.projection;
+    }
   };
 }
 #endif // PYASGE_GLRENDERSTATE_HPP
@@ -13,6 +13,7 @@
 #include "Logger.hpp"
 #include "GLRenderTarget.hpp"
 #include "GLRenderer.hpp"
+#include "GLStateCache.hpp"
 #include "GLTexture.hpp"
 
 ASGE::GLRenderTarget::GLRenderTarget(
@@ -28,6 +29,8 @@ ASGE::GLRenderTarget::GLRenderTarget(
 ASGE::GLRenderTarget::~GLRenderTarget()
 {
   glDeleteRenderbuffers(1, &MSAA_DBO);
+  GLStateCache::getInstance().forgetFramebuffer(MSAA_FBO);
+  GLStateCache::getInstance().forgetFramebuffer(FBO);
   glDeleteFramebuffers(1, &MSAA_FBO);
   glDeleteFramebuffers(1, &FBO);
 }
@@ -35,7 +38,7 @@ ASGE::GLRenderTarget::~GLRenderTarget()
 /* @brief Binds the MSAA frame buffer, ready for rendering. */
 void ASGE::GLRenderTarget::use() const
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, MSAA_FBO);
+  GLStateCache::getInstance().bindFramebuffer(GL_FRAMEBUFFER, MSAA_FBO);
 }
 
 /* @brief Returns the most recently resolved textures.
@@ -67,7 +70,7 @@ const std::vector<std::unique_ptr<ASGE::GLTexture>>& ASGE::GLRenderTarget::getRe
  */
 void ASGE::GLRenderTarget::createFboWithMultiSampledAttachments(ASGE::Renderer* renderer, int width, int height, ASGE::Texture2D::Format format, int count)
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, MSAA_FBO);
+  GLStateCache::getInstance().bindFramebuffer(GL_FRAMEBUFFER, MSAA_FBO);
 
   // The texture buffers
   msaa_textures.reserve(count);
@@ -99,7 +102,7 @@ void ASGE::GLRenderTarget::createFboWithMultiSampledAttachments(ASGE::Renderer*
     Logging::ERRORS("Attempt to create a valid MSAA FrameBuffer has failed");
   }
 
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  GLStateCache::getInstance().bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 /* @brief Creates a new FBO without MSAA support.
@@ -116,7 +119,7 @@ void ASGE::GLRenderTarget::createFboWithMultiSampledAttachments(ASGE::Renderer*
  */
 void ASGE::GLRenderTarget::createFboWithAttachments(ASGE::Renderer* renderer, int width, int height, ASGE::Texture2D::Format format, int count)
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  GLStateCache::getInstance().bindFramebuffer(GL_FRAMEBUFFER, FBO);
 
   // The texture buffers
   resolved_textures.reserve(count);
@@ -148,7 +151,7 @@ void ASGE::GLRenderTarget::createFboWithAttachments(ASGE::Renderer* renderer, in
     Logging::ERRORS("Attempt to create a valid MSAA FrameBuffer has failed");
   }
 
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  GLStateCache::getInstance().bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 /* @brief Resolves the MSAA texture at specified index.
@@ -168,10 +171,10 @@ ASGE::Texture2D* ASGE::GLRenderTarget::resolve(unsigned int index)
   auto height = static_cast<GLint>(resolved_texture->getHeight());
 
   // https://stackoverflow.com/a/48125123, automatically flip on the Y AXIS
-  glBindFramebuffer(GL_READ_FRAMEBUFFER, MSAA_FBO);
-  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+  GLStateCache::getInstance().bindFramebuffer(GL_READ_FRAMEBUFFER, MSAA_FBO);
+  GLStateCache::getInstance().bindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
   glBlitFramebuffer(0, 0, width, height, 0, height, width, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  GLStateCache::getInstance().bindFramebuffer(GL_FRAMEBUFFER, 0);
 
   resolved_texture->updateMips();
   ASGE::ClearGLErrors();
@@ -19,6 +19,9 @@
 #include "GLRenderTarget.hpp"
 #include "GLRenderer.hpp"
 #include "GLSprite.hpp"
+#include "GLSpritePool.hpp"
+#include "GLStateCache.hpp"
+#include "GLStaticSpriteLayer.hpp"
 #include "GLTextureCache.hpp"
 #include "Logger.hpp"
 #include "OpenGL/Shaders/GLShaders.vs"
@@ -166,6 +169,7 @@ bool ASGE::GLRenderer::init(const ASGE::GameSettings& settings)
       window = glfwCreateWindow(width, height, "ASGE", nullptr, msaa_window);
       glfwMakeContextCurrent(window);
       glfwDestroyWindow(msaa_window);
+      GLStateCache::getInstance().reset();
 
       // Initialise the GL Sprite Renderer
       item.second();
@@ -180,16 +184,23 @@ bool ASGE::GLRenderer::init(const ASGE::GameSettings& settings)
   centerWindow();
 
   GLTextureCache::getInstance().renderer = this;
+  GLTextureCache::getInstance().atlas.setThreshold(settings.texture_atlas_threshold);
   setWindowedMode(settings.mode);
   setWindowTitle(settings.game_title.c_str());
   glfwShowWindow(this->window);
   magFilter(settings.mag_filter);
   glGetIntegerv(GL_VIEWPORT, &resolution_info.viewport.x);
+  GLStateCache::getInstance().viewport(resolution_info.viewport);
 
   text_renderer = std::make_unique<GLAtlasManager>();
   text_renderer->init();
+  sprite_renderer->setQuadBudget(static_cast<GLuint>(std::max(settings.quad_buffer_budget, 1)));
   sprite_renderer->init();
   batch.sprite_renderer = sprite_renderer.get();
+  batch.mapped_payloads = sprite_renderer->mappedQuads();
+  batch.setQuadGenWorkers(static_cast<unsigned int>(std::max(settings.render_threads, 0)));
+  batch.setCulling(settings.cull_sprites);
+  sprite_renderer->setGpuCulling(settings.gpu_cull_sprites);
 
   switch(settings.vsync)
   {
@@ -203,7 +214,7 @@ bool ASGE::GLRenderer::init(const ASGE::GameSettings& settings)
 
   const auto& cls = clearColour();
   glClearColor(cls.r, cls.g, cls.b, 1.0F);
-  glEnable(GL_MULTISAMPLE);
+  GLStateCache::getInstance().enable(GL_MULTISAMPLE);
   ClearGLErrors(__PRETTY_FUNCTION__);
   allocateDebugTexture();
   setProjectionMatrix(0, 0, resolution_info.window[0], resolution_info.window[1]);
@@ -215,7 +226,9 @@ bool ASGE::GLRenderer::init(const ASGE::GameSettings& settings)
 void ASGE::GLRenderer::allocateDebugTexture()
 {
   // Create one pixel texture
-  auto *blank_texture = createCachedTexture("__asge__debug__texture__", 1, 1, GLTexture::RGBA, nullptr);
+  auto *blank_texture = GLTextureCache::getInstance().createCached(
+    "__asge__debug__texture__", 1, 1, GLTexture::RGBA, nullptr);
+  GLTextureCache::getInstance().debug_texture = blank_texture;
   auto *pixel_buffer = blank_texture->getPixelBuffer();
   const static std::array<std::byte, 4> PIXEL{
     static_cast<std::byte>(255),  // R
@@ -265,6 +278,27 @@ std::unique_ptr<ASGE::Sprite> ASGE::GLRenderer::createUniqueSprite()
   return std::make_unique<GLSprite>();
 }
 
+/**
+ *  Creates a number of OpenGL sprites.
+ *  The sprite pool is grown once to fit them all, so the sprites
+ *  are packed together and no further allocations are needed.
+ *
+ *  @param count The number of sprites to create.
+ *  @return The newly allocated sprites.
+ */
+std::vector<std::unique_ptr<ASGE::Sprite>> ASGE::GLRenderer::createUniqueSprites(std::size_t count)
+{
+  GLSpritePool::getInstance().reserve(count);
+
+  std::vector<std::unique_ptr<Sprite>> sprites;
+  sprites.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    sprites.push_back(std::make_unique<GLSprite>());
+  }
+  return sprites;
+}
+
 /**
  *  Creates a OpenGL sprite.
  *  Depending on the rendering system used, sprites need additional
@@ -279,6 +313,18 @@ ASGE::Sprite* ASGE::GLRenderer::createRawSprite()
   return new GLSprite;
 }
 
+/**
+ *  Creates an OpenGL retained sprite layer.
+ *  The layer owns a buffer that holds its sprites' GPU data, which is
+ *  only updated when the layer's sprites are marked as dirty.
+ *
+ *  @return A uniquely owned sprite layer.
+ */
+std::unique_ptr<ASGE::StaticSpriteLayer> ASGE::GLRenderer::createStaticSpriteLayer()
+{
+  return std::make_unique<GLStaticSpriteLayer>();
+}
+
 /**
  *  Gets the window.
  *  Returns the GLFWwindow that is used to manage the rendering.
@@ -348,19 +394,21 @@ void ASGE::GLRenderer::renderDebug(int fps)
   resolution_info.viewport = {0,0,width,height};
   setProjectionMatrix({ 0, 0, static_cast<float>(width), static_cast<float>(height) });
 
-  std::string fps_str = std::to_string(fps);
   constexpr auto POS_X    = 25.F;
   constexpr auto POS_Y    = 34.F; // renderer->getDefaultFont().line_height;
 
-  auto text = ASGE::Text{ getFont(0) };
-  text.setString(fps_str);
+  // the text and its string are kept between frames, so once their
+  // buffers have grown the overlay is built without allocating
+  debug_string.assign(std::to_string(fps));
+  debug_text.setFont(getFont(0));
+  debug_text.setString(debug_string);
   //text.setColour({ 1.0F, 0.2F, 0.75F });
-  text.setColour(COLOURS::DEEPPINK);
-  text.setPosition({ POS_X, POS_Y });
-  text.setScale(0.5);
-  render(std::move(text));
+  debug_text.setColour(COLOURS::DEEPPINK);
+  debug_text.setPosition({ POS_X, POS_Y });
+  debug_text.setScale(0.5);
+  batch.renderText(debug_text);
 
-  std::string debug_string;
+  debug_string.clear();
   switch (batch.getSpriteMode())
   {
     case ASGE::SpriteSortMode::IMMEDIATE:
@@ -385,16 +433,27 @@ void ASGE::GLRenderer::renderDebug(int fps)
     }
   }
 
-  debug_string += (std::string("DRAW COUNT: ") + std::to_string(batch.current_draw_count));
-
-  Text debug_text = { getFont(0), debug_string.c_str(), static_cast<int>(POS_X), 52, ASGE::COLOURS::PINK };
+  debug_string.append("DRAW COUNT: ").append(std::to_string(batch.current_draw_count));
+  debug_string.append("\nGPU STALLS: ").append(std::to_string(renderStats().gpu_stalls));
+  debug_string.append(" (").append(std::to_string(renderStats().gpu_stall_ms)).append("ms)");
+  debug_string.append("\nCULLED: ").append(std::to_string(batch.sprites_culled));
+  debug_string.append("/").append(std::to_string(batch.sprites_submitted));
+  debug_string.append("\nIN FLIGHT: ").append(std::to_string(renderStats().bytes_in_flight / 1024)).append("KB");
+  debug_string.append("\nQUADS: ").append(std::to_string(renderStats().quad_high_water));
+  debug_string.append("/").append(std::to_string(renderStats().quad_capacity));
+  debug_string.append("\nGL SKIPPED: ").append(std::to_string(renderStats().gl_calls_avoided));
+  debug_string.append("\nALLOCS: ").append(std::to_string(renderStats().batch_allocations));
+
+  debug_text.setString(debug_string);
+  debug_text.setPosition({ POS_X, 52.F });
+  debug_text.setColour(ASGE::COLOURS::PINK);
   debug_text.setScale(0.25);
   batch.renderText(debug_text);
   batch.flush();
 
   // restore the original settings
   resolution_info.viewport = original_vp;
-  glViewport(original_vp.x, original_vp.y, original_vp.w, original_vp.h);
+  GLStateCache::getInstance().viewport(original_vp);
   setProjectionMatrix(original_projection);
 }
 
@@ -430,6 +489,13 @@ std::unique_ptr<ASGE::Input> ASGE::GLRenderer::inputPtr()
 void ASGE::GLRenderer::postRender()
 {
   batch.end();
+  render_stats = sprite_renderer->endFrame();
+  render_stats.sprites_submitted = batch.sprites_submitted;
+  render_stats.sprites_culled    = batch.sprites_culled;
+  render_stats.batch_allocations = batch.storage_allocations;
+  render_stats.gl_calls_avoided =
+    static_cast<std::uint32_t>(GLStateCache::getInstance().avoidedCalls());
+  GLStateCache::getInstance().resetAvoidedCalls();
   sprite_renderer->setActiveShader(nullptr);
 }
 
@@ -467,7 +533,7 @@ void ASGE::GLRenderer::fillViewPort(const ASGE::Viewport& viewport)
       static_cast<int>(std::round(window_width * scale_w)),
       static_cast<int>(std::round(window_height * scale_h)) };
 
-  glViewport(vp_modified.x, vp_modified.y, vp_modified.w, vp_modified.h);
+  GLStateCache::getInstance().viewport(vp_modified);
   resolution_info.viewport = vp_modified;
 }
 
@@ -517,7 +583,7 @@ void ASGE::GLRenderer::fitViewPort(const ASGE::Viewport& viewport)
       static_cast<int>(vp_width),
       static_cast<int>(vp_height) };
 
-  glViewport(vp_modified.x, vp_modified.y, vp_modified.w, vp_modified.h);
+  GLStateCache::getInstance().viewport(vp_modified);
   resolution_info.viewport = vp_modified;
 }
 
@@ -552,7 +618,7 @@ void ASGE::GLRenderer::centerViewPort(const ASGE::Viewport& viewport)
       static_cast<int>(viewport.w),
       static_cast<int>(viewport.h) };
 
-  glViewport(vp_modified.x, vp_modified.y, vp_modified.w, vp_modified.h);
+  GLStateCache::getInstance().viewport(vp_modified);
   resolution_info.viewport = vp_modified;
 }
 
@@ -858,6 +924,27 @@ void ASGE::GLRenderer::render(const Sprite& spr)
     batch.renderSprite(spr);
 }
 
+void ASGE::GLRenderer::render(std::span<const Sprite* const> sprites)
+{
+  batch.renderSprites(sprites);
+}
+
+void ASGE::GLRenderer::render(
+  const Texture2D& texture, std::span<const SpriteInstance> instances, int16_t z_order,
+  const SHADER_LIB::Shader* shader)
+{
+  batch.renderInstances(
+    dynamic_cast<const GLTexture&>(texture),
+    instances,
+    z_order,
+    dynamic_cast<const SHADER_LIB::GLShader*>(shader));
+}
+
+void ASGE::GLRenderer::render(const SpriteStore& store)
+{
+  batch.renderStore(store);
+}
+
 void ASGE::GLRenderer::render(const ASGE::Text& text)
 {
   this->batch.renderText(text);
@@ -895,16 +982,23 @@ void ASGE::GLRenderer::setRenderTarget(RenderTarget* render_target)
     return;
   }
 
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  GLStateCache::getInstance().bindFramebuffer(GL_FRAMEBUFFER, 0);
   active_buffer = nullptr;
 }
 
 void ASGE::GLRenderer::render(const ASGE::Tile& tile, const ASGE::Point2D& xy)
 {
-  ASGE::GLSprite sprite {tile};
-  sprite.xPos(xy.x);
-  sprite.yPos(xy.y);
-  render(sprite);
+  batch.renderTiles({ &tile, 1 }, { &xy, 1 });
+}
+
+void ASGE::GLRenderer::render(std::span<const Tile> tiles, std::span<const Point2D> positions)
+{
+  batch.renderTiles(tiles, positions);
+}
+
+void ASGE::GLRenderer::render(ASGE::StaticSpriteLayer& layer)
+{
+  batch.renderLayer(dynamic_cast<GLStaticSpriteLayer&>(layer));
 }
 
 /**
@@ -922,15 +1016,13 @@ void ASGE::GLRenderer::render(
   ASGE::Texture2D& texture, std::array<float, 4> rect,
   const Point2D& pos_xy, int width, int height, int16_t z_order)
 {
-  ASGE::GLSprite sprite;
-  sprite.xPos(static_cast<float>(pos_xy.x));
-  sprite.yPos(static_cast<float>(pos_xy.y));
-  sprite.attach(&texture, Sprite::AttachMode::DEFAULT);
-  sprite.width(static_cast<float>(width));
-  sprite.height(static_cast<float>(height));
-  sprite.setGlobalZOrder(z_order);
-  std::copy(rect.begin(), rect.end(), sprite.srcRect());
-  render(sprite);
+  ASGE::Tile tile;
+  tile.texture  = &texture;
+  tile.src_rect = rect;
+  tile.width    = width;
+  tile.height   = height;
+  tile.z        = z_order;
+  batch.renderTiles({ &tile, 1 }, { &pos_xy, 1 });
 }
 
 /**
@@ -1033,6 +1125,7 @@ void ASGE::GLRenderer::saveState()
   constexpr float max = std::numeric_limits<decltype(RenderQuad::z_order)>::max();
   auto view  = resolution_info.view;
   state.projection = glm::ortho(view.min_x, view.max_x, view.max_y, view.min_y, min, max);
+  state.view       = view;
   batch.saveState(std::move(state));
 }
 
@@ -70,7 +70,9 @@ namespace ASGE
     void renderDebug(int fps);
 
     std::unique_ptr<Sprite> createUniqueSprite() override;
+    std::vector<std::unique_ptr<Sprite>> createUniqueSprites(std::size_t count) override;
     Sprite* createRawSprite() override;
+    std::unique_ptr<StaticSpriteLayer> createStaticSpriteLayer() override;
     GLFWwindow* getWindow();
 
     // Inherited via Renderer
@@ -106,9 +108,16 @@ namespace ASGE
     void setProjectionMatrix(float min_x, float max_x, float min_y, float max_y) override;
     void setProjectionMatrix(const Camera::CameraView& view) override;
     void render(const Sprite& sprite) override;
+    void render(std::span<const Sprite* const> sprites) override;
+    void render(
+      const Texture2D& texture, std::span<const SpriteInstance> instances, int16_t z_order,
+      const SHADER_LIB::Shader* shader) override;
+    void render(const SpriteStore& store) override;
     void render(const Text& string) override;
     void render(Text&& string) override;
     void render(const ASGE::Tile& tile, const ASGE::Point2D& xy) override;
+    void render(std::span<const ASGE::Tile> tiles, std::span<const ASGE::Point2D> positions) override;
+    void render(ASGE::StaticSpriteLayer& layer) override;
     void render(ASGE::Texture2D &texture, std::array<float, 4> rect, const Point2D &xy, int width, int height, int16_t z) override;
 
     ASGE::Viewport getViewport() const override;
@@ -138,5 +147,7 @@ namespace ASGE
     std::unique_ptr<CGLSpriteRenderer> sprite_renderer{};
     std::unique_ptr<GLAtlasManager> text_renderer{};
     GLFWwindow* window{ nullptr };
+    Text debug_text{};
+    std::string debug_string{};
   };
 }  // namespace ASGE
\ No newline at end of file
@@ -0,0 +1,141 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLRingAllocator.hpp"
+
+ASGE::GLRingAllocator::~GLRingAllocator()
+{
+  if (glfwGetCurrentContext() != nullptr)
+  {
+    for (auto& block : blocks)
+    {
+      glDeleteSync(block.sync);
+    }
+  }
+}
+
+/**
+ *  Sizes the ring, discarding any existing allocations.
+ *
+ *  @param capacity The number of elements in the ring.
+ *  @param element_alignment Every allocation starts on a multiple of this.
+ */
+void ASGE::GLRingAllocator::reset(GLuint capacity, GLuint element_alignment) noexcept
+{
+  for (auto& block : blocks)
+  {
+    glDeleteSync(block.sync);
+  }
+
+  blocks.clear();
+  size            = capacity;
+  alignment       = element_alignment == 0 ? 1 : element_alignment;
+  head            = 0;
+  used            = 0;
+  open_block      = 0;
+}
+
+/**
+ *  Allocates a contiguous range from the head of the ring.
+ *  An allocation that would run past the end of the ring wraps
+ *  around to the start, the skipped elements are counted as part
+ *  of the allocation until it is retired.
+ *
+ *  @param count The number of elements needed.
+ *  @return The offset of the range, or nullopt if the ring is full.
+ */
+std::optional<GLuint> ASGE::GLRingAllocator::allocate(GLuint count) noexcept
+{
+  if (count > size)
+  {
+    return std::nullopt;
+  }
+
+  auto start = (head + alignment - 1) / alignment * alignment;
+  if (start + count > size)
+  {
+    start = 0;
+  }
+
+  const auto consumed = (start >= head ? start - head : size - head + start) + count;
+  if (used + consumed > size)
+  {
+    return std::nullopt;
+  }
+
+  used += consumed;
+  open_block += consumed;
+  head = start + count;
+  return start;
+}
+
+/**
+ *  Closes the allocations made since the last fence into a block.
+ *  The block is released by retire once the GPU passes the fence.
+ */
+void ASGE::GLRingAllocator::fence()
+{
+  blocks.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), open_block });
+  open_block = 0;
+}
+
+/**
+ *  Releases the oldest block. Its fence must have been waited on.
+ */
+void ASGE::GLRingAllocator::retire()
+{
+  if (blocks.empty())
+  {
+    return;
+  }
+
+  glDeleteSync(blocks.front().sync);
+  used -= blocks.front().size;
+  blocks.pop_front();
+}
+
+/**
+ *  Releases every block the GPU has finished with, without waiting.
+ */
+void ASGE::GLRingAllocator::retireCompleted()
+{
+  while (!blocks.empty())
+  {
+    const auto status = glClientWaitSync(blocks.front().sync, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+    {
+      return;
+    }
+
+    retire();
+  }
+}
+
+bool ASGE::GLRingAllocator::hasPendingFence() const noexcept
+{
+  return !blocks.empty();
+}
+
+GLsync& ASGE::GLRingAllocator::oldestFence() noexcept
+{
+  return blocks.front().sync;
+}
+
+GLuint ASGE::GLRingAllocator::capacity() const noexcept
+{
+  return size;
+}
+
+GLuint ASGE::GLRingAllocator::inFlight() const noexcept
+{
+  return used;
+}
@@ -0,0 +1,68 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#ifndef ASGE_GLRINGALLOCATOR_HPP
+#define ASGE_GLRINGALLOCATOR_HPP
+
+#include "GLIncludes.hpp"
+#include <deque>
+#include <optional>
+
+namespace ASGE
+{
+  /**
+   * Sub-allocates a persistently mapped buffer as a ring.
+   * Allocations are made from the head of the ring and are grouped
+   * into blocks, each of which is closed with a fence, typically
+   * once per frame. A block's space is only handed out again once
+   * the block has been retired, after its fence has signalled.
+   * The ring works in elements rather than bytes, so each buffer
+   * of quads or draw commands has its own allocator.
+   */
+  class GLRingAllocator
+  {
+   public:
+    GLRingAllocator() = default;
+    ~GLRingAllocator();
+
+    GLRingAllocator(const GLRingAllocator&) = delete;
+    GLRingAllocator& operator=(const GLRingAllocator&) = delete;
+
+    void reset(GLuint capacity, GLuint element_alignment) noexcept;
+    [[nodiscard]] std::optional<GLuint> allocate(GLuint count) noexcept;
+
+    void fence();
+    void retire();
+    void retireCompleted();
+    [[nodiscard]] bool hasPendingFence() const noexcept;
+    [[nodiscard]] GLsync& oldestFence() noexcept;
+
+    [[nodiscard]] GLuint capacity() const noexcept;
+    [[nodiscard]] GLuint inFlight() const noexcept;
+
+   private:
+    struct Block
+    {
+      GLsync sync = nullptr;
+      GLuint size = 0;
+    };
+
+    std::deque<Block> blocks{};
+    GLuint size       = 0;
+    GLuint alignment  = 1;
+    GLuint head       = 0;
+    GLuint used       = 0;
+    GLuint open_block = 0;
+  };
+}  // namespace ASGE
+
+#endif // ASGE_GLRINGALLOCATOR_HPP
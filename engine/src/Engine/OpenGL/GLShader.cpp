@@ -13,18 +13,20 @@
 #include <iostream>
 #include "Logger.hpp"
 #include "GLShader.hpp"
+#include "GLStateCache.hpp"
 
 ASGE::SHADER_LIB::GLShader::~GLShader()
 {
   if ((this->ID != 0U) && (glfwGetCurrentContext() != nullptr))
   {
+    GLStateCache::getInstance().forgetProgram(this->ID);
     glDeleteProgram(this->ID);
   }
 }
 
 ASGE::SHADER_LIB::GLShader& ASGE::SHADER_LIB::GLShader::use()
 {
-  glUseProgram(this->ID);
+  GLStateCache::getInstance().useProgram(this->ID);
   return *this;
 }
 
@@ -12,9 +12,13 @@
 
 #include <Viewport.hpp>
 #include "GLSprite.hpp"
+#include "GLSpritePool.hpp"
+#include "GLStateCache.hpp"
 #include "GLTextureCache.hpp"
 #include "Logger.hpp"
 #include "Tile.hpp"
+#include <algorithm>
+#include <utility>
 
 bool ASGE::GLSprite::loadTexture(const std::string& file, AttachMode mode)
 {
@@ -25,10 +29,30 @@ bool ASGE::GLSprite::loadTexture(const std::string& file, AttachMode mode)
     return true;
   }
 
-  texture = GLTextureCache::getInstance().createCached("__asge__debug__texture__");
+  texture = GLTextureCache::getInstance().debugTexture();
 	return false;
 }
 
+/**
+ *  Sprites are allocated from the sprite pool, so creating and
+ *  destroying them in bulk recycles the same memory.
+ */
+void* ASGE::GLSprite::operator new(std::size_t size)
+{
+  return size == sizeof(GLSprite) ? GLSpritePool::getInstance().allocate() : ::operator new(size);
+}
+
+void ASGE::GLSprite::operator delete(void* sprite, std::size_t size) noexcept
+{
+  if (size == sizeof(GLSprite))
+  {
+    GLSpritePool::getInstance().deallocate(sprite);
+    return;
+  }
+
+  ::operator delete(sprite);
+}
+
 void ASGE::GLSprite::attach(ASGE::Sprite::AttachMode mode)
 {
   using AttachMode = ASGE::Sprite::AttachMode;
@@ -103,11 +127,87 @@ const ASGE::SHADER_LIB::GLShader* ASGE::GLSprite::asGLShader() const
   return gl_shader;
 }
 
-ASGE::GLSprite::GLSprite()
+/**
+ *  Copies out the inputs to the sprite's geometry.
+ *
+ *  @return The position, scaled size, rotation, flips and sampling.
+ */
+ASGE::GLSprite::GeometryInputs ASGE::GLSprite::geometryInputs() const noexcept
+{
+  GeometryInputs inputs;
+  inputs.x        = xPos();
+  inputs.y        = yPos();
+  inputs.width    = width() * scale();
+  inputs.height   = height() * scale();
+  inputs.rotation = rotationInRadians();
+  inputs.texture  = texture;
+  inputs.flip_x   = isFlippedOnX() || isFlippedOnXY();
+  inputs.flip_y   = isFlippedOnY() || isFlippedOnXY();
+  std::copy(srcRect(), srcRect() + inputs.src_rect.size(), inputs.src_rect.begin());
+  return inputs;
+}
+
+/**
+ *  Whether the sprite's transform and UVs can be reused as they are.
+ *  The source rectangle can be written through srcRect() at any time,
+ *  so it's compared rather than tracked.
+ *
+ *  @return True if the cached geometry is up to date.
+ */
+bool ASGE::GLSprite::isGeometryCached() const noexcept
 {
-  Sprite::loadTexture("__asge__debug__texture__");
-  ASGE::Viewport viewport;
-  glGetIntegerv(GL_VIEWPORT, &viewport.x);
+  return !isDirty(QUAD_DIRTY) && geometry.texture == texture &&
+         std::equal(geometry.src_rect.begin(), geometry.src_rect.end(), srcRect());
+}
+
+/**
+ *  Copies the cached transform, translation and UVs into a quad.
+ *
+ *  @param quad The quad to write to.
+ *  @return False if the cache was out of date and nothing was copied.
+ */
+bool ASGE::GLSprite::cachedGeometry(GPUQuad& quad) const noexcept
+{
+  if (!isGeometryCached())
+  {
+    return false;
+  }
+
+  quad.transform   = geometry.transform;
+  quad.uv_rect     = geometry.uv_rect;
+  quad.translation = geometry.translation;
+  return true;
+}
+
+/**
+ *  Stores freshly generated geometry, to be reused until the sprite
+ *  changes. Not thread safe, so only stored whilst the sprite is queued.
+ *
+ *  @param quad The quad the geometry was generated into.
+ */
+void ASGE::GLSprite::cacheGeometry(const GPUQuad& quad) const noexcept
+{
+  geometry.transform   = quad.transform;
+  geometry.uv_rect     = quad.uv_rect;
+  geometry.translation = quad.translation;
+  geometry.texture     = texture;
+  std::copy(srcRect(), srcRect() + geometry.src_rect.size(), geometry.src_rect.begin());
+  clearDirty(QUAD_DIRTY);
+}
+
+/**
+ *  Creates a sprite showing the debug texture.
+ *  The texture is fetched directly and the viewport comes from the
+ *  state cache, so no GL queries or string lookups are made.
+ */
+ASGE::GLSprite::GLSprite() : texture(GLTextureCache::getInstance().debugTexture())
+{
+  if (texture != nullptr)
+  {
+    attach(AttachMode::DEFAULT);
+  }
+
+  const auto& viewport = GLStateCache::getInstance().getViewport();
     auto ratio = std::max(
     static_cast<float>(viewport.w) / 1920.F,
     static_cast<float>(viewport.h) / 1080.F);
@@ -128,6 +228,10 @@ ASGE::GLSprite::GLSprite(const ASGE::Tile& tile) :
 
   if(texture == nullptr)
   {
-    Sprite::loadTexture("__asge__debug__texture__");
+    texture = GLTextureCache::getInstance().debugTexture();
+    if (texture != nullptr)
+    {
+      attach(AttachMode::DEFAULT);
+    }
   }
 }
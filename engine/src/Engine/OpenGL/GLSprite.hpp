@@ -11,9 +11,11 @@
 //  SOFTWARE.
 
 #pragma once
+#include "GLQuad.hpp"
 #include "GLShader.hpp"
 #include "GLTexture.hpp"
 #include "Sprite.hpp"
+#include <array>
 #include <string>
 
 namespace ASGE
@@ -29,14 +31,55 @@ namespace ASGE
     GLSprite();
     ~GLSprite() override = default;
     explicit GLSprite(const ASGE::Tile&);
+    static void* operator new(std::size_t size);
+    static void operator delete(void* sprite, std::size_t size) noexcept;
     bool attach(ASGE::Texture2D* texture_to_attach, AttachMode mode) noexcept override;
     bool loadTexture(const std::string& file, AttachMode mode) override;
     [[nodiscard]] Texture2D* getTexture() const override;
     [[nodiscard]] const GLTexture* asGLTexture() const noexcept;
     [[nodiscard]] const SHADER_LIB::GLShader* asGLShader() const;
 
+    /**
+     * Everything the sprite's transform and UVs are generated from.
+     * Copied when a sprite is queued for deferred generation, so that
+     * changing the sprite afterwards can't alter the queued quad.
+     */
+    struct GeometryInputs
+    {
+      float x        = 0.0F;
+      float y        = 0.0F;
+      float width    = 0.0F;  // scaled
+      float height   = 0.0F;  // scaled
+      float rotation = 0.0F;
+      std::array<float, 4> src_rect{};
+      const GLTexture* texture = nullptr;
+      bool flip_x              = false;
+      bool flip_y              = false;
+
+      bool operator==(const GeometryInputs&) const = default;
+    };
+
+    [[nodiscard]] GeometryInputs geometryInputs() const noexcept;
+    [[nodiscard]] bool isGeometryCached() const noexcept;
+    [[nodiscard]] bool cachedGeometry(GPUQuad& quad) const noexcept;
+    void cacheGeometry(const GPUQuad& quad) const noexcept;
+
   private:
+    /**
+     * The transform and UVs last generated for the sprite. Valid until
+     * the sprite's transform changes, or it samples something else.
+     */
+    struct GeometryCache
+    {
+      glm::vec4 transform{};
+      glm::vec4 uv_rect{};
+      glm::vec2 translation{};
+      std::array<float, 4> src_rect{};
+      const GLTexture* texture = nullptr;
+    };
+
 		GLTexture* texture = nullptr;
+    mutable GeometryCache geometry{};
     void attach(AttachMode mode);
   };
 }
\ No newline at end of file
@@ -11,15 +11,24 @@
 //  SOFTWARE.
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <limits>
+#include <utility>
 
 #include "GLAtlas.hpp"
 #include "GLAtlasManager.h"
 #include "GLFontSet.hpp"
 #include "GLIncludes.hpp"
 #include "GLModernSpriteRenderer.hpp"
+#include "GLQuadTransform.hpp"
 #include "GLRenderBatch.hpp"
 #include "GLSprite.hpp"
 #include "GLSpriteBatch.hpp"
+#include "GLStateCache.hpp"
+#include "GLStaticSpriteLayer.hpp"
+#include "GLTextureCache.hpp"
 
 /**
  *  The constructor for the sprite batch.
@@ -37,10 +46,7 @@
  *  @see ASGE::MGLSpriteRenderer
  *  @see ASGE::GLTextRenderer
  */
-ASGE::GLSpriteBatch::GLSpriteBatch()
-{
-  quads.reserve(GLRenderConstants::MAX_BATCH_COUNT);
-}
+ASGE::GLSpriteBatch::GLSpriteBatch() = default;
 
 /**
  *  Sets the OpenGL render state for drawing quads.
@@ -52,15 +58,17 @@ ASGE::GLSpriteBatch::GLSpriteBatch()
  */
 void ASGE::GLSpriteBatch::begin()
 {
-  glEnable(GL_BLEND);
-  glEnable(GL_DEPTH_TEST);
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-  glBlendEquation(GL_FUNC_ADD);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glDisable(GL_DEPTH_TEST);
-  glCullFace(GL_FRONT);
-  glEnable(GL_CULL_FACE);
-  glActiveTexture(GL_TEXTURE0);
+  auto& state = GLStateCache::getInstance();
+  state.enable(GL_BLEND);
+  state.disable(GL_DEPTH_TEST);
+  state.bindFramebuffer(GL_FRAMEBUFFER, 0);
+  state.blendEquation(GL_FUNC_ADD);
+  state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  state.cullFace(GL_FRONT);
+  state.enable(GL_CULL_FACE);
+  state.activeTexture(0);
+  sprites_submitted = 0;
+  sprites_culled    = 0;
 }
 
 /**
@@ -72,38 +80,413 @@ void ASGE::GLSpriteBatch::begin()
  *  If this is the cause it will cause an immediate flush of all
  *  the render data to prevent buffer overruns from occuring.
  *
- *  @param spr The game sprite being rendered.
- *  @param z_order The ordering value used to create layers.
+ *  When quad generation workers are available, the GPU data for
+ *  the sprite is not generated here. Instead the sprite's geometry
+ *  inputs are copied and the quad is generated from them when the
+ *  batch is flushed, so the sprite can be moved and rendered again
+ *  in the meantime.
+ *
+ *  @param sprite The game sprite being rendered.
  *
  *  @see ASGE::SpriteSortMode
  */
 void ASGE::GLSpriteBatch::renderSprite(const ASGE::Sprite& sprite)
 {
-  /// todo: thread the render quad generation process
-  auto gl_sprite = dynamic_cast<const ASGE::GLSprite&>(sprite);
+  const auto& gl_sprite = dynamic_cast<const ASGE::GLSprite&>(sprite);
+  const bool defer      = quad_gen_workers != 0 && render_mode != SpriteSortMode::IMMEDIATE;
+  const bool queued     = queueSprite(gl_sprite, gl_sprite.asGLShader(), fallbackShaderID(), defer, sprite_block);
+  finishBlock(sprite_block);
+  if (!queued)
+  {
+    return;
+  }
+
+  if (render_mode == SpriteSortMode::IMMEDIATE)
+  {
+    flush();
+  }
+}
+
+/**
+ *  Renders a collection of sprites in a single call.
+ *  Everything that is shared between the sprites, such as the shader
+ *  to fall back on and the render state, is resolved once. The sprites
+ *  must have been created by the GL renderer, so they are converted
+ *  without any checked casts, and are then queued in a tight loop.
+ *  Sprites whose geometry must be generated now are transformed in
+ *  blocks, the same as instances.
+ *
+ *  @param sprites The sprites to render.
+ */
+void ASGE::GLSpriteBatch::renderSprites(std::span<const Sprite* const> sprites)
+{
+  if (render_mode == SpriteSortMode::IMMEDIATE)
+  {
+    for (const auto* sprite : sprites)
+    {
+      renderSprite(*sprite);
+    }
+    return;
+  }
+
+  const auto fallback_shader = fallbackShaderID();
+  const bool defer           = quad_gen_workers != 0;
+
+  quads.reserve(quads.size() + sprites.size());
+  if (mapped_payloads == nullptr)
+  {
+    payloads.reserve(payloads.size() + sprites.size());
+  }
+  if (defer)
+  {
+    deferred_quads.reserve(deferred_quads.size() + sprites.size());
+  }
+
+  for (const auto* sprite : sprites)
+  {
+    const auto& gl_sprite = static_cast<const GLSprite&>(*sprite);
+    const auto* shader    = static_cast<const SHADER_LIB::GLShader*>(gl_sprite.getPixelShader());
+    queueSprite(gl_sprite, shader, fallback_shader, defer, sprite_block);
+  }
+
+  finishBlock(sprite_block);
+}
+
+/**
+ *  Renders raw instance records that share a texture and shader.
+ *  The records are transformed straight into the GPU data, so no
+ *  sprite is needed, but each still gets its own render quad so
+ *  that sorting, culling and render states behave as for sprites.
+ *  Visible instances are gathered into blocks and transformed
+ *  together.
+ *
+ *  @param texture The texture sampled by the instances.
+ *  @param instances The instances to render.
+ *  @param z_order The z order of every instance.
+ *  @param shader The shader to use, or nullptr for the fallback.
+ */
+void ASGE::GLSpriteBatch::renderInstances(
+  const GLTexture& texture, std::span<const SpriteInstance> instances, int16_t z_order,
+  const SHADER_LIB::GLShader* shader)
+{
+  const auto shader_id  = shader != nullptr ? shader->getShaderID() : fallbackShaderID();
+  const auto texture_id = texture.getID();
+  auto* state           = current_state;
+
+  quads.reserve(quads.size() + instances.size());
+  if (mapped_payloads == nullptr)
+  {
+    payloads.reserve(payloads.size() + instances.size());
+  }
+
+  const auto mapping = uvMapping(texture);
+  PendingBlock pending;
+
+  sprites_submitted += static_cast<unsigned int>(instances.size());
+  for (const auto& instance : instances)
+  {
+    if (
+      cull_sprites &&
+      !isVisible(instance.x, instance.y, instance.width, instance.height, instance.rotation))
+    {
+      ++sprites_culled;
+      continue;
+    }
+
+    RenderQuad& quad = emplaceBlockQuad(pending);
+    quad.texture_id  = texture_id;
+    quad.z_order     = z_order;
+    quad.state       = state;
+    quad.shader_id   = shader_id;
+
+    auto& gpu_data   = payload(quad.payload_idx);
+    gpu_data.colour  = packColour(instance.tint.r, instance.tint.g, instance.tint.b, instance.opacity);
+    gpu_data.z_order = z_order;
+
+    pending.block.set(
+      pending.count,
+      instance.x,
+      instance.y,
+      instance.width,
+      instance.height,
+      instance.rotation,
+      instance.src_rect.data(),
+      mapping);
+    commitLane(pending, gpu_data);
+  }
+
+  finishBlock(pending);
+
+  if (render_mode == SpriteSortMode::IMMEDIATE)
+  {
+    flush();
+  }
+}
+
+/**
+ *  Renders every sprite in a store.
+ *  The store's arrays are walked in order and fed through the same
+ *  block transform as instances. Neighbouring sprites usually share
+ *  a texture, so its UV mapping is only rebuilt when it changes.
+ *
+ *  @param store The sprites to render.
+ */
+void ASGE::GLSpriteBatch::renderStore(const SpriteStore& store)
+{
+  const auto count     = store.size();
+  const auto shader_id = fallbackShaderID();
+  auto* state          = current_state;
+
+  const auto xs        = store.xs();
+  const auto ys        = store.ys();
+  const auto widths    = store.widths();
+  const auto heights   = store.heights();
+  const auto rotations = store.rotations();
+  const auto scales    = store.scales();
+  const auto opacities = store.opacities();
+  const auto colours   = store.colours();
+  const auto src_rects = store.srcRects();
+  const auto textures  = store.textures();
+  const auto z_orders  = store.zOrders();
+
+  quads.reserve(quads.size() + count);
+  if (mapped_payloads == nullptr)
+  {
+    payloads.reserve(payloads.size() + count);
+  }
+
+  const GLTexture* mapped_texture = nullptr;
+  UvMapping mapping;
+  PendingBlock pending;
+
+  sprites_submitted += static_cast<unsigned int>(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto* texture = static_cast<const GLTexture*>(textures[i]);
+    const auto width    = widths[i] * scales[i];
+    const auto height   = heights[i] * scales[i];
+    if (texture == nullptr)
+    {
+      continue;
+    }
+
+    if (cull_sprites && !isVisible(xs[i], ys[i], width, height, rotations[i]))
+    {
+      ++sprites_culled;
+      continue;
+    }
+
+    if (texture != mapped_texture)
+    {
+      mapped_texture = texture;
+      mapping        = uvMapping(*texture);
+    }
+
+    RenderQuad& quad = emplaceBlockQuad(pending);
+    quad.texture_id  = texture->getID();
+    quad.z_order     = z_orders[i];
+    quad.state       = state;
+    quad.shader_id   = shader_id;
+
+    auto& gpu_data   = payload(quad.payload_idx);
+    gpu_data.colour  = packColour(colours[i].r, colours[i].g, colours[i].b, opacities[i]);
+    gpu_data.z_order = z_orders[i];
+
+    pending.block.set(
+      pending.count, xs[i], ys[i], width, height, rotations[i], src_rects[i].data(), mapping);
+    commitLane(pending, gpu_data);
+  }
+
+  finishBlock(pending);
+
+  if (render_mode == SpriteSortMode::IMMEDIATE)
+  {
+    flush();
+  }
+}
+
+/**
+ *  Renders tiles at the given positions.
+ *  Each tile's fields are fed straight into the block transform, so
+ *  unlike a sprite nothing needs to be created for it. Tiles without
+ *  a texture show the debug texture at its own size, untinted and
+ *  unrotated, as a sprite would once it's attached.
+ *
+ *  @param tiles The tiles to render.
+ *  @param positions Where to render each tile, in world space.
+ */
+void ASGE::GLSpriteBatch::renderTiles(std::span<const Tile> tiles, std::span<const Point2D> positions)
+{
+  const auto count          = std::min(tiles.size(), positions.size());
+  const auto shader_id      = fallbackShaderID();
+  const auto* debug_texture = GLTextureCache::getInstance().debugTexture();
+  auto* state               = current_state;
+
+  // untextured tiles take the debug texture's size, and the default
+  // rotation and tint, exactly as attaching it to a sprite would
+  Tile debug_tile{};
+  if (debug_texture != nullptr)
+  {
+    debug_tile.width    = static_cast<int>(debug_texture->getWidth());
+    debug_tile.height   = static_cast<int>(debug_texture->getHeight());
+    debug_tile.src_rect = { 0, 0, debug_texture->getWidth(), debug_texture->getHeight() };
+  }
+
+  quads.reserve(quads.size() + count);
+  if (mapped_payloads == nullptr)
+  {
+    payloads.reserve(payloads.size() + count);
+  }
+
+  const GLTexture* mapped_texture = nullptr;
+  UvMapping mapping;
+  PendingBlock pending;
+
+  sprites_submitted += static_cast<unsigned int>(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto textured  = tiles[i].texture != nullptr;
+    const auto& tile     = textured ? tiles[i] : debug_tile;
+    const auto [x, y]    = positions[i];
+    const auto width     = static_cast<float>(tile.width);
+    const auto height    = static_cast<float>(tile.height);
+    const auto* texture  = textured ? static_cast<const GLTexture*>(tile.texture) : debug_texture;
+    if (texture == nullptr)
+    {
+      continue;
+    }
+
+    if (cull_sprites && !isVisible(x, y, width, height, tile.rotation))
+    {
+      ++sprites_culled;
+      continue;
+    }
+
+    if (texture != mapped_texture)
+    {
+      mapped_texture = texture;
+      mapping        = uvMapping(*texture);
+    }
+
+    RenderQuad& quad = emplaceBlockQuad(pending);
+    quad.texture_id  = texture->getID();
+    quad.z_order     = tiles[i].z;
+    quad.state       = state;
+    quad.shader_id   = shader_id;
+
+    auto& gpu_data   = payload(quad.payload_idx);
+    gpu_data.colour  = packColour(tile.tint.r, tile.tint.g, tile.tint.b, tiles[i].opacity);
+    gpu_data.z_order = tiles[i].z;
+
+    pending.block.set(pending.count, x, y, width, height, tile.rotation, tile.src_rect.data(), mapping);
+    commitLane(pending, gpu_data);
+  }
+
+  finishBlock(pending);
+
+  if (render_mode == SpriteSortMode::IMMEDIATE)
+  {
+    flush();
+  }
+}
+
+/**
+ *  Queues a sprite's quad, unless the sprite has been culled.
+ *  Unchanged sprites copy their cached geometry. Otherwise their
+ *  geometry inputs are either copied for the workers to generate at
+ *  flush time, or added to the pending block. The block stores the
+ *  geometry in the sprite's cache, so it must be finished before the
+ *  sprite is given back to the caller.
+ *
+ *  @param sprite The sprite to queue.
+ *  @param shader The sprite's own shader, if it has one.
+ *  @param fallback_shader The shader to use when the sprite has none.
+ *  @param defer Whether to generate the quad's data at flush time.
+ *  @param pending The block to generate the quad in, if it isn't deferred.
+ *  @return True if the sprite was queued.
+ */
+bool ASGE::GLSpriteBatch::queueSprite(
+  const GLSprite& sprite, const SHADER_LIB::GLShader* shader, GLuint fallback_shader, bool defer,
+  SpriteBlock& pending)
+{
+  ++sprites_submitted;
+  if (cull_sprites && !isVisible(sprite.getWorldBounds()))
+  {
+    ++sprites_culled;
+    return false;
+  }
 
   // generate a render quad from sprite
-  RenderQuad& quad = quads.emplace_back();
-  quad.texture_id  = gl_sprite.asGLTexture()->getID();
-  quad.z_order     = gl_sprite.getGlobalZOrder();
-  quad.state       = &states.back();
+  RenderQuad& quad = emplaceBlockQuad(pending);
+  quad.texture_id  = sprite.asGLTexture()->getID();
+  quad.z_order     = sprite.getGlobalZOrder();
+  quad.state       = current_state;
+  quad.shader_id   = shader != nullptr ? shader->getShaderID() : fallback_shader;
+
+  auto& gpu_data   = payload(quad.payload_idx);
+  gpu_data.colour  = packColour(sprite.colour().r, sprite.colour().g, sprite.colour().b, sprite.opacity());
+  gpu_data.z_order = sprite.getGlobalZOrder();
 
-  if (gl_sprite.asGLShader() != nullptr)
+  // unchanged sprites are only copied, which isn't worth deferring
+  if (sprite.cachedGeometry(gpu_data))
   {
-    quad.shader_id = gl_sprite.asGLShader()->getShaderID();
+    return true;
   }
-  else if (
-    sprite_renderer->activeShader() != nullptr &&
-    sprite_renderer->activeShader()->getShaderID() != sprite_renderer->getDefaultTextShaderID())
+
+  if (defer)
   {
-    quad.shader_id = sprite_renderer->activeShader()->getShaderID();
+    // the sprite may change before the flush, so its inputs are copied
+    auto& deferred       = deferred_quads.emplace_back();
+    deferred.payload_idx = quad.payload_idx;
+    deferred.is_sprite   = true;
+    deferred.geometry    = sprite.geometryInputs();
+    return true;
   }
-  else
+
+  commitLane(pending, sprite.geometryInputs(), gpu_data, &sprite);
+  return true;
+}
+
+/**
+ *  The shader used by sprites without one of their own.
+ *  This is the active shader, unless it's the text shader, in
+ *  which case the basic sprite shader is used.
+ *
+ *  @return The fallback shader's ID.
+ */
+GLuint ASGE::GLSpriteBatch::fallbackShaderID() const
+{
+  const auto* active = sprite_renderer->activeShader();
+  if (active != nullptr && active->getShaderID() != sprite_renderer->getDefaultTextShaderID())
   {
-    quad.shader_id = sprite_renderer->getBasicSpriteShaderID();
+    return active->getShaderID();
   }
 
-  sprite_renderer->quadGen(gl_sprite, quad.gpu_data);
+  return sprite_renderer->getBasicSpriteShaderID();
+}
+
+/**
+ *  Renders a retained sprite layer.
+ *  The layer is queued alongside the other quads using its global
+ *  z-order, so it is drawn at the correct point once sorted. Its
+ *  GPU data is only refreshed when the batch is flushed.
+ *
+ *  @param layer The layer to render.
+ */
+void ASGE::GLSpriteBatch::renderLayer(GLStaticSpriteLayer& layer)
+{
+  if (layers.size() == std::numeric_limits<GLushort>::max())
+  {
+    flush();
+  }
+
+  layers.emplace_back(&layer);
+
+  RenderQuad& quad = quads.emplace_back();
+  quad.z_order     = layer.getGlobalZOrder();
+  quad.state       = current_state;
+  quad.layer_idx   = static_cast<GLushort>(layers.size());
+
   if (render_mode == SpriteSortMode::IMMEDIATE)
   {
     flush();
@@ -137,40 +520,423 @@ ASGE::SpriteSortMode ASGE::GLSpriteBatch::getSpriteMode() const
   return render_mode;
 }
 
-void ASGE::GLSpriteBatch::sortQuads()
+/**
+ *  Sets the number of workers used to generate quads.
+ *  When set to zero, quads are generated on the calling thread as
+ *  each sprite is rendered. Otherwise, the generation of the quads
+ *  is deferred until the batch is flushed and is split across the
+ *  requested number of workers.
+ *
+ *  @param workers The number of workers, including the calling thread.
+ */
+void ASGE::GLSpriteBatch::setQuadGenWorkers(unsigned int workers)
+{
+  generateDeferredQuads();
+  quad_gen_workers = workers;
+  worker_pool.resize(workers);
+}
+
+/**
+ *  Enables culling of sprites that fall outside the camera view.
+ *  Culled sprites are dropped before any of their data is generated.
+ *
+ *  @param enabled Whether sprites should be culled.
+ */
+void ASGE::GLSpriteBatch::setCulling(bool enabled) noexcept
+{
+  cull_sprites = enabled;
+}
+
+/**
+ *  Tests a quad against the active camera view.
+ *  Rather than generating the quad's world bounds, its rotated
+ *  rectangle is enclosed in an axis aligned box around its centre.
+ *
+ *  @param x The left edge of the quad.
+ *  @param y The top edge of the quad.
+ *  @param width The scaled width of the quad, which may be negative.
+ *  @param height The scaled height of the quad, which may be negative.
+ *  @param rotation The rotation around the quad's centre in radians.
+ *  @return True if the quad may be visible.
+ */
+bool ASGE::GLSpriteBatch::isVisible(
+  float x, float y, float width, float height, float rotation) const
+{
+  const auto& view    = current_state->view;
+  const auto half_w   = std::abs(width) * 0.5F;
+  const auto half_h   = std::abs(height) * 0.5F;
+  const auto cos_r    = std::abs(std::cos(rotation));
+  const auto sin_r    = std::abs(std::sin(rotation));
+  const auto extent_x = cos_r * half_w + sin_r * half_h;
+  const auto extent_y = sin_r * half_w + cos_r * half_h;
+  const auto centre_x = x + width * 0.5F;
+  const auto centre_y = y + height * 0.5F;
+
+  // views can be flipped, so don't assume min is less than max
+  return centre_x + extent_x >= std::min(view.min_x, view.max_x) &&
+         centre_x - extent_x <= std::max(view.min_x, view.max_x) &&
+         centre_y + extent_y >= std::min(view.min_y, view.max_y) &&
+         centre_y - extent_y <= std::max(view.min_y, view.max_y);
+}
+
+/**
+ *  Tests a sprite's world bounds against the active camera view.
+ *  The bounds are cached by the sprite, so unchanged sprites are
+ *  tested without any trigonometry.
+ *
+ *  @param bounds The four corners of the sprite in world space.
+ *  @return True if the sprite may be visible.
+ */
+bool ASGE::GLSpriteBatch::isVisible(const SpriteBounds& bounds) const
+{
+  const auto& view = current_state->view;
+  const auto min_x = std::min({ bounds.v1.x, bounds.v2.x, bounds.v3.x, bounds.v4.x });
+  const auto max_x = std::max({ bounds.v1.x, bounds.v2.x, bounds.v3.x, bounds.v4.x });
+  const auto min_y = std::min({ bounds.v1.y, bounds.v2.y, bounds.v3.y, bounds.v4.y });
+  const auto max_y = std::max({ bounds.v1.y, bounds.v2.y, bounds.v3.y, bounds.v4.y });
+
+  // views can be flipped, so don't assume min is less than max
+  return max_x >= std::min(view.min_x, view.max_x) && min_x <= std::max(view.min_x, view.max_x) &&
+         max_y >= std::min(view.min_y, view.max_y) && min_y <= std::max(view.min_y, view.max_y);
+}
+
+/**
+ *  Queues a new quad.
+ *  The sort and batch metadata is stored separately from the GPU
+ *  data, which is referenced by index. Only the metadata is moved
+ *  when sorting. If the sprite renderer maps its quad buffer, the
+ *  GPU data is written straight into it and only the sorted order
+ *  is uploaded, otherwise it's gathered in order on upload.
+ *
+ *  @return The metadata for the new quad.
+ */
+ASGE::RenderQuad& ASGE::GLSpriteBatch::emplaceQuad()
+{
+  if (mapped_payloads == nullptr)
+  {
+    auto& quad       = quads.emplace_back();
+    quad.payload_idx = static_cast<GLuint>(payloads.size());
+    payloads.emplace_back();
+    return quad;
+  }
+
+  if (next_payload == payload_chunk_end)
+  {
+    reservePayloads();
+  }
+
+  auto& quad       = quads.emplace_back();
+  quad.payload_idx = next_payload++;
+  ++mapped_payload_count;
+  return quad;
+}
+
+/**
+ *  Queues a new quad whose transform will be generated as part of
+ *  a block. Reserving more mapped quads may flush the quads already
+ *  queued, so a pending block is finished before that can happen.
+ *
+ *  @param pending The block the quad will join.
+ *  @return The metadata for the new quad.
+ */
+ASGE::RenderQuad& ASGE::GLSpriteBatch::emplaceBlockQuad(PendingBlock& pending)
+{
+  if (mapped_payloads != nullptr && next_payload == payload_chunk_end)
+  {
+    finishBlock(pending);
+  }
+
+  return emplaceQuad();
+}
+
+/**
+ *  Adds a quad to the block, once its lane has been filled in.
+ *  The block is transformed as soon as every lane is in use.
+ *
+ *  @param pending The block being filled.
+ *  @param quad The quad the lane is written to.
+ */
+void ASGE::GLSpriteBatch::commitLane(PendingBlock& pending, GPUQuad& quad) noexcept
+{
+  pending.quads[pending.count] = &quad;
+  if (++pending.count == QuadBlock::LANES)
+  {
+    finishBlock(pending);
+  }
+}
+
+void ASGE::GLSpriteBatch::finishBlock(PendingBlock& pending) noexcept
+{
+  transformQuads(pending.block, std::exchange(pending.count, 0), pending.quads.data());
+}
+
+/**
+ *  Queues a new sprite quad whose transform will be generated as
+ *  part of a block, finishing the block first if reserving more
+ *  mapped quads could flush the ones already queued.
+ *
+ *  @param pending The block the quad may join.
+ *  @return The metadata for the new quad.
+ */
+ASGE::RenderQuad& ASGE::GLSpriteBatch::emplaceBlockQuad(SpriteBlock& pending)
+{
+  if (mapped_payloads != nullptr && next_payload == payload_chunk_end)
+  {
+    finishBlock(pending);
+  }
+
+  return emplaceQuad();
+}
+
+/**
+ *  Adds a sprite's geometry to the block, transforming the block as
+ *  soon as every lane is in use. Only touches the block and the quad,
+ *  so the workers can fill blocks of their own.
+ *
+ *  @param pending The block being filled.
+ *  @param inputs The sprite's geometry inputs.
+ *  @param quad The quad the lane is written to.
+ *  @param cache_owner The sprite to cache the geometry in, or nullptr
+ *  if it may not outlive the block.
+ */
+void ASGE::GLSpriteBatch::commitLane(
+  SpriteBlock& pending, const GLSprite::GeometryInputs& inputs, GPUQuad& quad,
+  const GLSprite* cache_owner) noexcept
+{
+  if (inputs.texture != pending.mapped_texture)
+  {
+    pending.mapped_texture = inputs.texture;
+    pending.mapping        = uvMapping(*inputs.texture);
+  }
+
+  const auto lane = pending.count;
+  pending.block.set(
+    lane, inputs.x, inputs.y, inputs.width, inputs.height, inputs.rotation, inputs.src_rect.data(),
+    pending.mapping);
+  pending.quads[lane]   = &quad;
+  pending.sprites[lane] = cache_owner;
+  pending.flip_x[lane]  = inputs.flip_x;
+  pending.flip_y[lane]  = inputs.flip_y;
+
+  if (++pending.count == QuadBlock::LANES)
+  {
+    finishBlock(pending);
+  }
+}
+
+/**
+ *  Transforms the block's sprites and writes them to their quads.
+ *  Flipping swaps the generated UVs, exactly as geometryGen does,
+ *  so the output matches a sprite generated on its own.
+ *
+ *  @param pending The block to finish.
+ */
+void ASGE::GLSpriteBatch::finishBlock(SpriteBlock& pending) noexcept
 {
-  auto predicate = [render_mode = this->render_mode](
-                     const RenderQuad& lhs, const RenderQuad& rhs) {
-    auto lhs_z_order    = lhs.z_order;
-    auto rhs_z_order    = rhs.z_order;
-    auto lhs_texture_id = lhs.texture_id;
-    auto rhs_texture_id = rhs.texture_id;
-    // auto lhs_shader_id = lhs.shader_id;
-    // auto rhs_shader_id = rhs.shader_id;
-    // auto lhs_alpha = lhs.gpu_data.color.a;
-    // auto rhs_alpha = rhs.gpu_data.color.a;
-
-    if (render_mode == SpriteSortMode::TEXTURE)
+  const auto count = std::exchange(pending.count, 0);
+  if (count == 0)
+  {
+    return;
+  }
+
+  std::array<GPUQuad*, QuadBlock::LANES> staged{};
+  for (std::size_t lane = 0; lane < count; ++lane)
+  {
+    staged[lane] = &pending.staged[lane];
+  }
+
+  transformQuads(pending.block, count, staged.data());
+  for (std::size_t lane = 0; lane < count; ++lane)
+  {
+    auto& quad = pending.staged[lane];
+    if (pending.flip_x[lane])
     {
-      return (lhs_texture_id < rhs_texture_id);
+      std::swap(quad.uv_rect.x, quad.uv_rect.z);
     }
 
-    if (render_mode == SpriteSortMode::BACK_TO_FRONT)
+    if (pending.flip_y[lane])
     {
-      // if z order is lower
-      return (lhs_z_order < rhs_z_order) ||
-             (lhs_z_order == rhs_z_order && lhs_texture_id < rhs_texture_id);
+      std::swap(quad.uv_rect.y, quad.uv_rect.w);
     }
-    else
+
+    if (pending.sprites[lane] != nullptr)
     {
-      // if z order is higher
-      return (lhs_z_order > rhs_z_order) ||
-             (lhs_z_order == rhs_z_order && lhs_texture_id < rhs_texture_id);
+      pending.sprites[lane]->cacheGeometry(quad);
     }
+
+    // the destination may be mapped, so it's only ever written to
+    auto& dest       = *pending.quads[lane];
+    dest.transform   = quad.transform;
+    dest.uv_rect     = quad.uv_rect;
+    dest.translation = quad.translation;
+  }
+}
+
+/**
+ *  Reserves the next chunk of the renderer's mapped quads.
+ *  Quads that have been written but not yet drawn must not be
+ *  reclaimed by the renderer's ring, so once a flush's worth of
+ *  them have been queued they're flushed before reserving more.
+ *  Likewise, if the frame alone has filled the ring, the queued quads
+ *  are drawn before the renderer is allowed to fence them early.
+ *  The renderer may resize its buffers between frames, so the
+ *  mapping is refreshed with each chunk.
+ */
+void ASGE::GLSpriteBatch::reservePayloads()
+{
+  if (mapped_payload_count + PAYLOAD_CHUNK_SIZE > sprite_renderer->quadCapacity())
+  {
+    flush();
+  }
+
+  mapped_payloads = sprite_renderer->mappedQuads();
+  auto reserved   = sprite_renderer->reserveQuads(PAYLOAD_CHUNK_SIZE, false);
+  if (!reserved.has_value())
+  {
+    // this frame has filled the ring, so draw its quads before it's fenced
+    flush();
+    reserved = sprite_renderer->reserveQuads(PAYLOAD_CHUNK_SIZE, true);
+  }
+
+  next_payload      = *reserved;
+  payload_chunk_end = next_payload + PAYLOAD_CHUNK_SIZE;
+}
+
+ASGE::GPUQuad& ASGE::GLSpriteBatch::payload(GLuint idx) noexcept
+{
+  return mapped_payloads != nullptr ? mapped_payloads[idx] : payloads[idx];
+}
+
+/**
+ *  Generates all the deferred quads.
+ *  The deferred quads are divided into contiguous chunks, one per
+ *  worker, and run on the batch's worker pool with the calling
+ *  thread taking part. Small workloads are not worth the overhead
+ *  of threading and are processed in place. Each chunk transforms
+ *  its sprites in blocks, from the inputs copied at submission, and
+ *  writes them to the slots reserved for them, keeping their order.
+ */
+void ASGE::GLSpriteBatch::generateDeferredQuads()
+{
+  if (deferred_quads.empty())
+  {
+    return;
+  }
+
+  constexpr std::size_t MIN_QUADS_PER_WORKER = 1024;
+  const std::size_t count   = deferred_quads.size();
+  const std::size_t workers = std::clamp<std::size_t>(
+    count / MIN_QUADS_PER_WORKER, 1, std::max(quad_gen_workers, 1U));
+  const std::size_t chunk   = (count + workers - 1) / workers;
+
+  auto generate_chunk = [this, chunk, count](std::size_t task) {
+    SpriteBlock pending;
+    const auto end = std::min((task + 1) * chunk, count);
+    for (auto i = task * chunk; i < end; ++i)
+    {
+      const auto& deferred = deferred_quads[i];
+      auto& gpu_data       = payload(static_cast<GLuint>(deferred.payload_idx));
+      if (deferred.is_sprite)
+      {
+        // the sprite may no longer exist, so nothing is cached
+        commitLane(pending, deferred.geometry, gpu_data, nullptr);
+        continue;
+      }
+
+      sprite_renderer->createCharQuad(deferred.character, deferred.colour, gpu_data);
+    }
+
+    finishBlock(pending);
   };
 
-  std::stable_sort(quads.begin(), quads.end(), predicate);
-  return;
+  worker_pool.forEach((count + chunk - 1) / chunk, generate_chunk);
+  deferred_quads.clear();
+}
+
+void ASGE::GLSpriteBatch::sortQuads()
+{
+  // sort compact key/index records rather than the quad metadata
+  sort_keys.resize(quads.size());
+  for (std::uint32_t i = 0; i < quads.size(); ++i)
+  {
+    const auto& quad = quads[i];
+    sort_keys[i] = { packQuadSortKey(render_mode, quad.z_order, quad.texture_id), i };
+  }
+
+  radixSortQuadKeys(sort_keys, sort_scratch, &worker_pool);
+
+  // gather the metadata into sorted order, the payloads stay put
+  sorted_quads.reserve(quads.size());
+  for (const auto& record : sort_keys)
+  {
+    sorted_quads.emplace_back(quads[record.index]);
+  }
+
+  quads.swap(sorted_quads);
+  sorted_quads.clear();
+}
+
+/**
+ *  Splits the sorted quads into groups that can share a draw call.
+ *  Each group binds up to the renderer's texture slot limit, so
+ *  consecutive quads no longer need to share a texture to be drawn
+ *  together. A new group starts whenever the shader, its distance
+ *  or the render state changes, at a retained layer, or once the
+ *  group runs out of slots. Only the basic sprite shader can select
+ *  between slots, other shaders get a single texture per group.
+ *  The order of the quads is left untouched. Slots are kept with the
+ *  metadata and passed on when uploading, so the GPU data, which may
+ *  be mapped, is never written to again.
+ */
+void ASGE::GLSpriteBatch::assignTextureSlots()
+{
+  texture_groups.clear();
+
+  const auto max_slots     = sprite_renderer->getMaxTextureSlots();
+  const auto sprite_shader = sprite_renderer->getBasicSpriteShaderID();
+  const RenderQuad* previous = nullptr;
+  for (auto& quad : quads)
+  {
+    if (quad.layer_idx != 0)
+    {
+      previous = nullptr;
+      continue;
+    }
+
+    bool new_group = previous == nullptr || previous->shader_id != quad.shader_id ||
+                     previous->distance != quad.distance || previous->state != quad.state;
+
+    GLuint slot = 0;
+    if (!new_group)
+    {
+      auto& group     = texture_groups.back();
+      const auto used = group.ids.cbegin() + group.count;
+      slot = static_cast<GLuint>(
+        std::distance(group.ids.cbegin(), std::find(group.ids.cbegin(), used, quad.texture_id)));
+
+      const auto limit = quad.shader_id == sprite_shader ? max_slots : 1U;
+      if (slot == group.count && group.count < limit)
+      {
+        group.ids[group.count++] = quad.texture_id;
+      }
+      else if (slot == group.count)
+      {
+        new_group = true;
+      }
+    }
+
+    if (new_group)
+    {
+      auto& group  = texture_groups.emplace_back();
+      group.ids[0] = quad.texture_id;
+      group.count  = 1;
+      slot         = 0;
+    }
+
+    quad.group = static_cast<GLuint>(texture_groups.size() - 1);
+    quad.slot  = static_cast<GLushort>(slot);
+    previous = &quad;
+  }
 }
 
 /**
@@ -186,37 +952,80 @@ void ASGE::GLSpriteBatch::flush()
 {
   if (!quads.empty())
   {
+    generateDeferredQuads();
     sortQuads();
-    QuadRange upload_range{ quads.cbegin(), std::prev(quads.cend())};
-    while(upload_range.begin != quads.cend())
+    assignTextureSlots();
+
+    // retained layers split the quads into separately uploaded segments
+    auto segment_begin = quads.cbegin();
+    for (auto quad = quads.cbegin(); quad != quads.cend(); ++quad)
     {
-      const auto last_uploaded_quad = sprite_renderer->upload(upload_range);
-      auto&& batches = generateRenderBatches({upload_range.begin, last_uploaded_quad});
-      current_draw_count += sprite_renderer->render(std::move(batches));
-      upload_range.begin = std::next(last_uploaded_quad);
+      if (quad->layer_idx == 0)
+      {
+        continue;
+      }
+
+      renderQuads(segment_begin, quad);
+      auto* layer = layers[quad->layer_idx - 1];
+      layer->refresh(*sprite_renderer);
+      current_draw_count += sprite_renderer->render(*layer, quad->state);
+      segment_begin = std::next(quad);
     }
+
+    renderQuads(segment_begin, quads.cend());
     quads.clear();
+    payloads.clear();
+    layers.clear();
+    texture_groups.clear();
+    mapped_payload_count = 0;
   }
 
+  // the pooled states live until the end of the frame, but the
+  // GL state may be changed before the next batch is drawn
   sprite_renderer->clearActiveRenderState();
-  states.clear();
 }
 
 /**
+ *  Uploads and renders a segment of the sorted quads.
+ *  The segment is uploaded in as many passes as the sprite
+ *  renderer's buffers require.
  *
- * @return
+ *  @param begin The first quad in the segment.
+ *  @param end One past the last quad in the segment.
  */
-std::vector<ASGE::AnotherRenderBatch>
-ASGE::GLSpriteBatch::generateRenderBatches(const QuadRange& range)
+void ASGE::GLSpriteBatch::renderQuads(QuadIter begin, QuadIter end)
+{
+  if (begin == end)
+  {
+    return;
+  }
+
+  QuadRange upload_range{ begin, std::prev(end) };
+  while (upload_range.begin != end)
+  {
+    const auto last_uploaded_quad = sprite_renderer->upload(upload_range, payloads);
+    auto&& batches = generateRenderBatches({upload_range.begin, last_uploaded_quad});
+    current_draw_count += sprite_renderer->render(std::move(batches));
+    upload_range.begin = std::next(last_uploaded_quad);
+  }
+}
+
+/**
+ *  Splits an uploaded range of quads into draw batches.
+ *  The batches are allocated from the frame arena, so they must not
+ *  be kept beyond the end of the frame.
+ *
+ *  @param range The first and last quad of the upload.
+ *  @return The batches, in draw order.
+ */
+ASGE::RenderBatches ASGE::GLSpriteBatch::generateRenderBatches(const QuadRange& range)
 {
   auto batch_begin = range.begin;
   auto batch_end   = range.begin;
 
+  // the texture groups already account for shader and state changes
   auto should_end = [&batch_begin, &batch_end]() {
-    return batch_begin->texture_id != batch_end->texture_id ||
-           batch_begin->shader_id  != batch_end->shader_id  ||
-           batch_begin->distance   != batch_end->distance   ||
-           batch_begin->state      != batch_end->state;
+    return batch_begin->group != batch_end->group;
   };
 
   auto get_reason = [&batch_begin, &batch_end, &range]() {
@@ -226,10 +1035,6 @@ ASGE::GLSpriteBatch::generateRenderBatches(const QuadRange& range)
       reason.set(AnotherRenderBatch::NO_MORE_TO_RENDER);
       return reason;
     }
-    if (batch_begin->texture_id != batch_end->texture_id)
-    {
-      reason.set(AnotherRenderBatch::TEXTURE_CHANGE);
-    }
     if (batch_begin->shader_id != batch_end->shader_id ||
         batch_begin->distance  != batch_end->distance)
     {
@@ -239,17 +1044,23 @@ ASGE::GLSpriteBatch::generateRenderBatches(const QuadRange& range)
     {
       reason.set(AnotherRenderBatch::STATE_CHANGE);
     }
+    if (reason.none())
+    {
+      // the group ran out of texture slots
+      reason.set(AnotherRenderBatch::TEXTURE_CHANGE);
+    }
 
     return reason;
   };
 
-  std::vector<AnotherRenderBatch> batches;
+  RenderBatches batches{ &frame_arena };
+  batches.reserve(texture_groups.size());
   auto create_batch = [&](int64_t count) {
     auto& batch          = batches.emplace_back(AnotherRenderBatch{});
     batch.reason         = get_reason();
     batch.start_idx      = static_cast<GLuint>(std::distance(range.begin, batch_begin));
     batch.instance_count = static_cast<GLuint>(count);
-    batch.texture_id     = batch_begin->texture_id;
+    batch.textures       = texture_groups[batch_begin->group];
     batch.shader_id      = batch_begin->shader_id;
     batch.distance       = batch_begin->distance;
     batch.state          = batch_begin->state;
@@ -282,6 +1093,27 @@ void ASGE::GLSpriteBatch::end()
 {
   flush();
   current_draw_count = 0;
+
+  // the rest of the chunk is fenced along with the frame
+  next_payload      = 0;
+  payload_chunk_end = 0;
+
+  // only the current state outlives the frame, it's copied out of
+  // the arena so that everything else can be released at once
+  std::optional<RenderState> latest;
+  if (current_state != nullptr)
+  {
+    latest = *current_state;
+  }
+
+  states.clear();
+  current_state = nullptr;
+  frame_arena.reset();
+  countStorageAllocations();
+  if (latest)
+  {
+    current_state = &states.emplace_back(*latest);
+  }
 }
 
 void ASGE::GLSpriteBatch::renderText(const ASGE::Text& text)
@@ -307,12 +1139,12 @@ void ASGE::GLSpriteBatch::renderText(const ASGE::Text& text)
       continue;
     }
 
-    RenderQuad& quad = quads.emplace_back();
+    RenderQuad& quad = emplaceQuad();
     quad.texture_id  = font.getAtlas()->getTextureID();
     quad.shader_id   = sprite_renderer->getDefaultTextShaderID();
     quad.z_order     = text.getZOrder();
     quad.distance    = font.px_range * text.getScale();
-    quad.state       = &states.back();
+    quad.state       = current_state;
 
     // the character we want to render
     render_char.scale = text.getScale();
@@ -322,7 +1154,18 @@ void ASGE::GLSpriteBatch::renderText(const ASGE::Text& text)
     render_char.font  = &font;
     render_char.alpha = text.getOpacity();
 
-    sprite_renderer->createCharQuad(render_char, text.getColour(), quad.gpu_data);
+    if (quad_gen_workers != 0 && render_mode != SpriteSortMode::IMMEDIATE)
+    {
+      auto& deferred     = deferred_quads.emplace_back();
+      deferred.payload_idx = quad.payload_idx;
+      deferred.character = render_char;
+      deferred.colour    = text.getColour();
+    }
+    else
+    {
+      sprite_renderer->createCharQuad(render_char, text.getColour(), payload(quad.payload_idx));
+    }
+
     x += font.pxWide(render_char.ch, render_char.scale);
   }
 
@@ -332,7 +1175,52 @@ void ASGE::GLSpriteBatch::renderText(const ASGE::Text& text)
   }
 }
 
+/**
+ *  Counts the heap allocations made for the frame's storage.
+ *  Once every container has grown to fit the frame's workload, and
+ *  the arena has settled into a single block, this stays at zero.
+ *  The containers are only ever cleared, so any growth in their
+ *  capacity means they reallocated. Each one that grew is counted
+ *  once, however many times it reallocated during the frame.
+ */
+void ASGE::GLSpriteBatch::countStorageAllocations()
+{
+  const std::array<std::size_t, 8> capacity{
+    quads.capacity(),          sorted_quads.capacity(), payloads.capacity(),
+    sort_keys.capacity(),      sort_scratch.capacity(), deferred_quads.capacity(),
+    texture_groups.capacity(), layers.capacity()
+  };
+
+  // the quads are swapped with their sorted copy, so compare them as a pair
+  storage_allocations = static_cast<unsigned int>(frame_arena.allocations() - arena_allocations);
+  storage_allocations += capacity[0] + capacity[1] > storage_capacity[0] + storage_capacity[1] ? 1U : 0U;
+  for (std::size_t i = 2; i < capacity.size(); ++i)
+  {
+    storage_allocations += capacity[i] > storage_capacity[i] ? 1U : 0U;
+  }
+
+  arena_allocations = frame_arena.allocations();
+  storage_capacity  = capacity;
+}
+
+/**
+ *  Makes the state current, interning it in the frame's pool.
+ *  Quads refer to their state by pointer, so a state equal to one
+ *  already in the pool reuses it, and re-applying the same camera
+ *  or viewport no longer splits the batches drawn either side of it.
+ *  Few distinct states are used in a frame, so the pool is searched
+ *  linearly, starting with the most recent.
+ *
+ *  @param state The state to make current.
+ */
 void ASGE::GLSpriteBatch::saveState(RenderState&& state)
 {
-  states.emplace_back(std::move(state));
+  auto pooled = std::find(states.rbegin(), states.rend(), state);
+  if (pooled != states.rend())
+  {
+    current_state = &*pooled;
+    return;
+  }
+
+  current_state = &states.emplace_back(std::move(state));
 }
@@ -11,17 +11,29 @@
 //  SOFTWARE.
 
 #pragma once
+#include "GLFrameArena.hpp"
 #include "GLQuad.hpp"
 #include "GLRenderBatch.hpp"
 #include "Text.hpp"
 #include "GLRenderState.hpp"
+#include "GLQuadSort.hpp"
+#include "GLQuadTransform.hpp"
+#include "GLSprite.hpp"
+#include "GLWorkerPool.hpp"
+#include "SpriteStore.hpp"
+#include "Point2D.hpp"
+#include "Tile.hpp"
+#include <array>
+#include <span>
 #include <vector>
 
 namespace ASGE {
 
+	namespace SHADER_LIB { class GLShader; }
 	class CGLSpriteRenderer;
 	class GLAtlasManager;
-	class GLSprite;
+	class GLTexture;
+	class GLStaticSpriteLayer;
 
 	/**
 	*  A sprite batch class designed for OpenGL.
@@ -40,24 +52,125 @@ namespace ASGE {
     ~GLSpriteBatch() = default;
 
     void begin();
-    void renderSprite(const ASGE::Sprite&);
+    void renderSprite(const ASGE::Sprite& sprite);
+    void renderSprites(std::span<const Sprite* const> sprites);
+    void renderInstances(
+      const GLTexture& texture, std::span<const SpriteInstance> instances, int16_t z_order,
+      const SHADER_LIB::GLShader* shader);
+    void renderStore(const SpriteStore& store);
+    void renderTiles(std::span<const Tile> tiles, std::span<const Point2D> positions);
     void renderText(const ASGE::Text&);
+    void renderLayer(GLStaticSpriteLayer& layer);
 
     void flush();
     void end();
     void setSpriteMode(SpriteSortMode mode);
     SpriteSortMode getSpriteMode() const;
+    void setQuadGenWorkers(unsigned int workers);
+    void setCulling(bool enabled) noexcept;
 
    private:
+    /**
+     * A quad whose GPU data is generated at flush time. Either a copy
+     * of a sprite's geometry inputs, taken when it was queued, or a
+     * copy of the character to render. Nothing refers back to the
+     * sprite, so it may be changed or destroyed once it's queued.
+     */
+    struct DeferredQuad
+    {
+      std::size_t payload_idx = 0;
+      bool is_sprite          = false;
+      GLSprite::GeometryInputs geometry = {};
+      GLCharRender character  = {};
+      ASGE::Colour colour     = COLOURS::WHITE;
+    };
+
     mutable unsigned int current_draw_count = 0;
+    unsigned int sprites_submitted          = 0;
+    unsigned int sprites_culled             = 0;
+    unsigned int storage_allocations        = 0;
+    bool cull_sprites                       = false;
+    unsigned int quad_gen_workers           = 0;
     CGLSpriteRenderer* sprite_renderer      = nullptr;
     SpriteSortMode render_mode              = SpriteSortMode::BACK_TO_FRONT;
 
-    std::vector<ASGE::AnotherRenderBatch>
-    generateRenderBatches(const QuadRange& range);
+    RenderBatches generateRenderBatches(const QuadRange& range);
+    void generateDeferredQuads();
+    /**
+     * Quads whose transforms are waiting to be generated together.
+     * Each lane's quad is written once the block fills up.
+     */
+    struct PendingBlock
+    {
+      QuadBlock block{};
+      std::array<GPUQuad*, QuadBlock::LANES> quads{};
+      std::size_t count = 0;
+    };
+
+    /**
+     * Sprite quads waiting to be generated together. Sprites can be
+     * flipped and may cache their geometry, so the block is generated
+     * into local quads first, which are then copied to their payloads.
+     */
+    struct SpriteBlock
+    {
+      QuadBlock block{};
+      std::array<GPUQuad, QuadBlock::LANES> staged{};
+      std::array<GPUQuad*, QuadBlock::LANES> quads{};
+      std::array<const GLSprite*, QuadBlock::LANES> sprites{}; // whose cache to fill, if any
+      std::array<bool, QuadBlock::LANES> flip_x{};
+      std::array<bool, QuadBlock::LANES> flip_y{};
+      const GLTexture* mapped_texture = nullptr;
+      UvMapping mapping{};
+      std::size_t count = 0;
+    };
+
+    RenderQuad& emplaceQuad();
+    RenderQuad& emplaceBlockQuad(PendingBlock& pending);
+    RenderQuad& emplaceBlockQuad(SpriteBlock& pending);
+    void commitLane(PendingBlock& pending, GPUQuad& quad) noexcept;
+    static void commitLane(
+      SpriteBlock& pending, const GLSprite::GeometryInputs& inputs, GPUQuad& quad,
+      const GLSprite* cache_owner) noexcept;
+    void finishBlock(PendingBlock& pending) noexcept;
+    static void finishBlock(SpriteBlock& pending) noexcept;
+    void reservePayloads();
+    GPUQuad& payload(GLuint idx) noexcept;
+    bool queueSprite(
+      const GLSprite& sprite, const SHADER_LIB::GLShader* shader, GLuint fallback_shader, bool defer,
+      SpriteBlock& pending);
+    [[nodiscard]] GLuint fallbackShaderID() const;
+    [[nodiscard]] bool isVisible(float x, float y, float width, float height, float rotation) const;
+    [[nodiscard]] bool isVisible(const SpriteBounds& bounds) const;
     void sortQuads();
+    void assignTextureSlots();
+    void renderQuads(QuadIter begin, QuadIter end);
     void saveState(RenderState&& state);
+    void countStorageAllocations();
     QuadList quads;
-    std::list<RenderState> states{};
+    QuadList sorted_quads;
+    GPUQuadList payloads;
+
+    // mapped quads are reserved from the renderer a chunk at a time
+    static constexpr GLuint PAYLOAD_CHUNK_SIZE = 4096;
+    GPUQuad* mapped_payloads    = nullptr;
+    GLuint next_payload         = 0;
+    GLuint payload_chunk_end    = 0;
+    GLuint mapped_payload_count = 0;
+    std::vector<GLStaticSpriteLayer*> layers{};
+    std::vector<TextureSlots> texture_groups{};
+    std::vector<QuadSortKey> sort_keys{};
+    std::vector<QuadSortKey> sort_scratch{};
+    std::vector<DeferredQuad> deferred_quads{};
+    SpriteBlock sprite_block{}; // only pending during a single render call
+    GLWorkerPool worker_pool{};
+
+    // transient data is allocated from the arena, which is reset
+    // once the frame ends, so it must outlive everything using it
+    GLFrameArena frame_arena{};
+    std::size_t arena_allocations = 0;
+    std::array<std::size_t, 8> storage_capacity{};
+    std::pmr::list<RenderState> states{ &frame_arena };
+    RenderState* current_state = nullptr;
   };
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "GLSpritePool.hpp"
+#include "GLSprite.hpp"
+#include <algorithm>
+#include <new>
+
+namespace
+{
+  // slots are padded so each one keeps the block's alignment
+  constexpr std::size_t SLOT_ALIGN = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  constexpr std::size_t SLOT_SIZE =
+    (sizeof(ASGE::GLSprite) + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+  static_assert(alignof(ASGE::GLSprite) <= SLOT_ALIGN, "GLSprite is over aligned for the pool");
+}  // namespace
+
+/**
+ *  Hands out a slot for a sprite, growing the pool if it's empty.
+ *
+ *  @return Uninitialised storage for one GLSprite.
+ */
+void* ASGE::GLSpritePool::allocate()
+{
+  std::scoped_lock lock(mutex);
+  if (free_slots.empty())
+  {
+    allocateBlock(BLOCK_SLOTS);
+  }
+
+  auto* slot = free_slots.back();
+  free_slots.pop_back();
+  return slot;
+}
+
+/**
+ *  Returns a destroyed sprite's slot to the pool.
+ *
+ *  @param slot The storage handed out by allocate.
+ */
+void ASGE::GLSpritePool::deallocate(void* slot) noexcept
+{
+  if (slot == nullptr)
+  {
+    return;
+  }
+
+  std::scoped_lock lock(mutex);
+  free_slots.push_back(slot);
+}
+
+/**
+ *  Makes sure a number of sprites can be created without the pool
+ *  touching the heap again.
+ *
+ *  @param count The number of sprites about to be created.
+ */
+void ASGE::GLSpritePool::reserve(std::size_t count)
+{
+  std::scoped_lock lock(mutex);
+  if (free_slots.size() < count)
+  {
+    allocateBlock(std::max(count - free_slots.size(), BLOCK_SLOTS));
+  }
+}
+
+std::size_t ASGE::GLSpritePool::capacity() const noexcept
+{
+  std::scoped_lock lock(mutex);
+  return slot_count;
+}
+
+std::size_t ASGE::GLSpritePool::available() const noexcept
+{
+  std::scoped_lock lock(mutex);
+  return free_slots.size();
+}
+
+/**
+ *  Allocates a block of slots and puts them all on the free list.
+ *  The free list is reserved up front so returning a slot never
+ *  needs to allocate. Must be called with the mutex held.
+ *
+ *  @param slots The number of slots in the block.
+ */
+void ASGE::GLSpritePool::allocateBlock(std::size_t slots)
+{
+  auto& block = blocks.emplace_back(std::make_unique<std::byte[]>(slots * SLOT_SIZE));
+  slot_count += slots;
+  free_slots.reserve(slot_count);
+
+  // reversed, so the block is handed out from its start
+  for (std::size_t i = slots; i-- > 0;)
+  {
+    free_slots.push_back(block.get() + i * SLOT_SIZE);
+  }
+}
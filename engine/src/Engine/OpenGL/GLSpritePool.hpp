@@ -0,0 +1,66 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#ifndef ASGE_GLSPRITEPOOL_HPP
+#define ASGE_GLSPRITEPOOL_HPP
+
+#include "NonCopyable.hpp"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ASGE
+{
+  /**
+   * Recycles the memory of destroyed sprites.
+   * Sprites are allocated from blocks of slots rather than one heap
+   * allocation each, and a destroyed sprite's slot goes on a free
+   * list for the next sprite to reuse. GLSprite's own new and delete
+   * route through the pool, so raw and unique sprites both benefit
+   * without any change in how they're freed. The blocks are kept
+   * until the pool is destroyed at exit.
+   */
+  class GLSpritePool final : public NonCopyable
+  {
+   public:
+    GLSpritePool(const GLSpritePool&) = delete;
+    GLSpritePool operator=(const GLSpritePool&) = delete;
+    static GLSpritePool& getInstance()
+    {
+      static GLSpritePool instance;
+      return instance;
+    }
+
+    [[nodiscard]] void* allocate();
+    void deallocate(void* slot) noexcept;
+    void reserve(std::size_t count);
+
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] std::size_t available() const noexcept;
+
+   private:
+    GLSpritePool() = default;
+    ~GLSpritePool() = default;
+
+    static constexpr std::size_t BLOCK_SLOTS = 256;
+    void allocateBlock(std::size_t slots);
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks{};
+    std::vector<void*> free_slots{};
+    std::size_t slot_count = 0;
+    mutable std::mutex mutex{};
+  };
+}  // namespace ASGE
+
+#endif // ASGE_GLSPRITEPOOL_HPP
@@ -0,0 +1,296 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLStateCache.hpp"
+#include <algorithm>
+
+/**
+ *  Forgets everything, so that all state is applied again.
+ *  Used when the context is created, or after GL has been used
+ *  without going through the cache.
+ */
+void ASGE::GLStateCache::reset() noexcept
+{
+  capabilities.fill(UNKNOWN);
+  for (auto& unit : textures)
+  {
+    unit.fill(UNKNOWN);
+  }
+
+  blend_equation    = UNKNOWN;
+  blend_source      = UNKNOWN;
+  blend_destination = UNKNOWN;
+  cull_face         = UNKNOWN;
+  program           = UNKNOWN;
+  active_unit       = UNKNOWN;
+  draw_framebuffer  = UNKNOWN;
+  read_framebuffer  = UNKNOWN;
+  viewport_known    = false;
+}
+
+/**
+ *  Must be called when a texture is deleted. GL unbinds it, and
+ *  its name may be reused by a new texture.
+ *
+ *  @param texture The texture being deleted.
+ */
+void ASGE::GLStateCache::forgetTexture(GLuint texture) noexcept
+{
+  for (auto& unit : textures)
+  {
+    std::replace(unit.begin(), unit.end(), texture, 0U);
+  }
+}
+
+/**
+ *  Must be called when a program is deleted.
+ *
+ *  @param program_id The program being deleted.
+ */
+void ASGE::GLStateCache::forgetProgram(GLuint program_id) noexcept
+{
+  // a program in use is only deleted once it's no longer in use
+  if (program == program_id)
+  {
+    program = UNKNOWN;
+  }
+}
+
+/**
+ *  Must be called when a framebuffer is deleted, GL falls back to
+ *  the default framebuffer for any target it was bound to.
+ *
+ *  @param framebuffer The framebuffer being deleted.
+ */
+void ASGE::GLStateCache::forgetFramebuffer(GLuint framebuffer) noexcept
+{
+  draw_framebuffer = draw_framebuffer == framebuffer ? 0 : draw_framebuffer;
+  read_framebuffer = read_framebuffer == framebuffer ? 0 : read_framebuffer;
+}
+
+/**
+ *  Records a new value for a piece of state.
+ *
+ *  @param cached The shadowed state.
+ *  @param value The value being set.
+ *  @return True if the call needs to be made.
+ */
+bool ASGE::GLStateCache::update(GLuint& cached, GLuint value) noexcept
+{
+  if (cached == value)
+  {
+    ++avoided;
+    return false;
+  }
+
+  cached = value;
+  return true;
+}
+
+void ASGE::GLStateCache::setCapability(GLenum capability, bool enabled)
+{
+  const auto* tracked = std::find(CAPABILITIES.begin(), CAPABILITIES.end(), capability);
+  if (
+    tracked != CAPABILITIES.end() &&
+    !update(capabilities[static_cast<std::size_t>(tracked - CAPABILITIES.begin())], enabled ? 1 : 0))
+  {
+    return;
+  }
+
+  enabled ? glEnable(capability) : glDisable(capability);
+}
+
+void ASGE::GLStateCache::enable(GLenum capability)
+{
+  setCapability(capability, true);
+}
+
+void ASGE::GLStateCache::disable(GLenum capability)
+{
+  setCapability(capability, false);
+}
+
+void ASGE::GLStateCache::blendEquation(GLenum mode)
+{
+  if (update(blend_equation, mode))
+  {
+    glBlendEquation(mode);
+  }
+}
+
+void ASGE::GLStateCache::blendFunc(GLenum source, GLenum destination)
+{
+  if (blend_source == source && blend_destination == destination)
+  {
+    ++avoided;
+    return;
+  }
+
+  blend_source      = source;
+  blend_destination = destination;
+  glBlendFunc(source, destination);
+}
+
+void ASGE::GLStateCache::cullFace(GLenum mode)
+{
+  if (update(cull_face, mode))
+  {
+    glCullFace(mode);
+  }
+}
+
+void ASGE::GLStateCache::useProgram(GLuint program_id)
+{
+  if (update(program, program_id))
+  {
+    glUseProgram(program_id);
+  }
+}
+
+/**
+ *  Selects the active texture unit.
+ *
+ *  @param unit The unit's index, not its GL_TEXTURE0 based enum.
+ */
+void ASGE::GLStateCache::activeTexture(GLuint unit)
+{
+  if (update(active_unit, unit))
+  {
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+}
+
+/**
+ *  Binds a texture to the active unit.
+ *  Bindings on units or targets that aren't tracked are always made.
+ *  If the active unit isn't known, unit 0 is made active first.
+ *
+ *  @param target The texture's target.
+ *  @param texture The texture to bind.
+ *  @return True if the texture was bound.
+ */
+bool ASGE::GLStateCache::bindTexture(GLenum target, GLuint texture)
+{
+  // the engine otherwise leaves unit 0 active
+  if (active_unit == UNKNOWN)
+  {
+    activeTexture(0);
+  }
+
+  auto* cached = trackedTexture(active_unit, target);
+  if (cached != nullptr && !update(*cached, texture))
+  {
+    return false;
+  }
+
+  glBindTexture(target, texture);
+  return true;
+}
+
+/**
+ *  Binds a texture to a unit. The unit is only made active if the
+ *  texture needs binding, so which unit is active afterwards isn't
+ *  guaranteed.
+ *
+ *  @param unit The unit's index.
+ *  @param target The texture's target.
+ *  @param texture The texture to bind.
+ *  @return True if the texture was bound.
+ */
+bool ASGE::GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+  const auto* cached = trackedTexture(unit, target);
+  if (cached != nullptr && *cached == texture)
+  {
+    ++avoided;
+    return false;
+  }
+
+  activeTexture(unit);
+  return bindTexture(target, texture);
+}
+
+/**
+ *  @return The cached binding, or nullptr if it isn't tracked.
+ */
+GLuint* ASGE::GLStateCache::trackedTexture(GLuint unit, GLenum target) noexcept
+{
+  const auto* tracked = std::find(TEXTURE_TARGETS.begin(), TEXTURE_TARGETS.end(), target);
+  if (unit >= TEXTURE_UNITS || tracked == TEXTURE_TARGETS.end())
+  {
+    return nullptr;
+  }
+
+  return &textures[unit][static_cast<std::size_t>(tracked - TEXTURE_TARGETS.begin())];
+}
+
+/**
+ *  Binds a framebuffer. GL_FRAMEBUFFER binds both the draw and the
+ *  read target, so it's only skipped if both are already bound.
+ *
+ *  @param target The target to bind to.
+ *  @param framebuffer The framebuffer to bind.
+ */
+void ASGE::GLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer)
+{
+  if (target == GL_FRAMEBUFFER)
+  {
+    if (draw_framebuffer == framebuffer && read_framebuffer == framebuffer)
+    {
+      ++avoided;
+      return;
+    }
+
+    draw_framebuffer = framebuffer;
+    read_framebuffer = framebuffer;
+  }
+  else if (!update(target == GL_READ_FRAMEBUFFER ? read_framebuffer : draw_framebuffer, framebuffer))
+  {
+    return;
+  }
+
+  glBindFramebuffer(target, framebuffer);
+}
+
+void ASGE::GLStateCache::viewport(const Viewport& viewport)
+{
+  if (viewport_known && !(current_viewport != viewport))
+  {
+    ++avoided;
+    return;
+  }
+
+  current_viewport = viewport;
+  viewport_known   = true;
+  glViewport(viewport.x, viewport.y, viewport.w, viewport.h);
+}
+
+/**
+ *  @return The last viewport set, without asking the driver.
+ */
+const ASGE::Viewport& ASGE::GLStateCache::getViewport() const noexcept
+{
+  return current_viewport;
+}
+
+/**
+ *  @return The number of calls skipped since the count was reset.
+ */
+std::uint64_t ASGE::GLStateCache::avoidedCalls() const noexcept
+{
+  return avoided;
+}
+
+void ASGE::GLStateCache::resetAvoidedCalls() noexcept
+{
+  avoided = 0;
+}
@@ -0,0 +1,97 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#ifndef ASGE_GLSTATECACHE_HPP
+#define ASGE_GLSTATECACHE_HPP
+
+#include "GLConstants.hpp"
+#include "GLIncludes.hpp"
+#include "NonCopyable.hpp"
+#include "Viewport.hpp"
+#include <array>
+#include <cstdint>
+
+namespace ASGE
+{
+  /**
+   * Shadows the GL state the engine changes.
+   * All bindings, programs, blending, culling and the viewport are
+   * set through the cache, which skips any call that wouldn't change
+   * anything. The driver is never queried, the cache only knows what
+   * it has been told, so anything set behind its back must be
+   * followed by a reset or the matching forget call. State that
+   * hasn't been set since a reset is unknown and is always applied.
+   */
+  class GLStateCache final : public NonCopyable
+  {
+   public:
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache operator=(const GLStateCache&) = delete;
+    static GLStateCache& getInstance()
+    {
+      static GLStateCache instance;
+      return instance;
+    }
+
+    void reset() noexcept;
+    void forgetTexture(GLuint texture) noexcept;
+    void forgetProgram(GLuint program_id) noexcept;
+    void forgetFramebuffer(GLuint framebuffer) noexcept;
+
+    void enable(GLenum capability);
+    void disable(GLenum capability);
+    void blendEquation(GLenum mode);
+    void blendFunc(GLenum source, GLenum destination);
+    void cullFace(GLenum mode);
+    void useProgram(GLuint program_id);
+    void activeTexture(GLuint unit);
+    bool bindTexture(GLenum target, GLuint texture);
+    bool bindTexture(GLuint unit, GLenum target, GLuint texture);
+    void bindFramebuffer(GLenum target, GLuint framebuffer);
+    void viewport(const Viewport& viewport);
+
+    [[nodiscard]] const Viewport& getViewport() const noexcept;
+    [[nodiscard]] std::uint64_t avoidedCalls() const noexcept;
+    void resetAvoidedCalls() noexcept;
+
+   private:
+    GLStateCache() { reset(); }
+    ~GLStateCache() = default;
+
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFF;
+    static constexpr GLuint TEXTURE_UNITS = GLRenderConstants::QUAD_TBO_UNIT + 1;
+    static constexpr std::array<GLenum, 4> CAPABILITIES{
+      GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_MULTISAMPLE };
+    static constexpr std::array<GLenum, 4> TEXTURE_TARGETS{
+      GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_BUFFER };
+
+    bool update(GLuint& cached, GLuint value) noexcept;
+    GLuint* trackedTexture(GLuint unit, GLenum target) noexcept;
+    void setCapability(GLenum capability, bool enabled);
+
+    std::array<GLuint, CAPABILITIES.size()> capabilities{};
+    std::array<std::array<GLuint, TEXTURE_TARGETS.size()>, TEXTURE_UNITS> textures{};
+    GLuint blend_equation    = UNKNOWN;
+    GLuint blend_source      = UNKNOWN;
+    GLuint blend_destination = UNKNOWN;
+    GLuint cull_face         = UNKNOWN;
+    GLuint program           = UNKNOWN;
+    GLuint active_unit       = UNKNOWN;
+    GLuint draw_framebuffer  = UNKNOWN;
+    GLuint read_framebuffer  = UNKNOWN;
+    Viewport current_viewport{};
+    bool viewport_known      = false;
+    std::uint64_t avoided    = 0;
+  };
+}  // namespace ASGE
+
+#endif // ASGE_GLSTATECACHE_HPP
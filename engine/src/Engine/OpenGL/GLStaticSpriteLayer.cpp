@@ -0,0 +1,248 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLStaticSpriteLayer.hpp"
+#include "CGLSpriteRenderer.hpp"
+#include "GLQuadSort.hpp"
+#include "GLSprite.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <string>
+
+ASGE::GLStaticSpriteLayer::~GLStaticSpriteLayer()
+{
+  if (glfwGetCurrentContext() != nullptr)
+  {
+    glDeleteBuffers(1, &buffer);
+  }
+}
+
+/**
+ *  Adds a sprite to the layer.
+ *  Adding a sprite changes the layout of the layer, so the
+ *  layer will be rebuilt the next time it's rendered.
+ *
+ *  @param sprite The sprite to retain.
+ *  @return The sprite's index within the layer.
+ */
+std::size_t ASGE::GLStaticSpriteLayer::add(const ASGE::Sprite& sprite)
+{
+  sprites.emplace_back(&dynamic_cast<const GLSprite&>(sprite));
+  needs_rebuild = true;
+  return sprites.size() - 1;
+}
+
+/**
+ *  Queues a sprite to be regenerated on the next refresh.
+ *  An index the layer never returned is reported and ignored.
+ *
+ *  @param index The index returned when the sprite was added.
+ */
+void ASGE::GLStaticSpriteLayer::markDirty(std::size_t index)
+{
+  if (index >= sprites.size())
+  {
+    Logging::WARN(__PRETTY_FUNCTION__);
+    Logging::WARN(
+      "Sprite " + std::to_string(index) + " is not in the layer, which holds " +
+      std::to_string(sprites.size()));
+    return;
+  }
+
+  dirty.emplace_back(index);
+}
+
+void ASGE::GLStaticSpriteLayer::markAllDirty()
+{
+  needs_rebuild = true;
+}
+
+void ASGE::GLStaticSpriteLayer::clear()
+{
+  sprites.clear();
+  dirty.clear();
+  needs_rebuild = true;
+}
+
+std::size_t ASGE::GLStaticSpriteLayer::size() const noexcept
+{
+  return sprites.size();
+}
+
+GLuint ASGE::GLStaticSpriteLayer::getBuffer() const noexcept
+{
+  return buffer;
+}
+
+GLsizeiptr ASGE::GLStaticSpriteLayer::getBufferSize() const noexcept
+{
+  return buffer_size;
+}
+
+const ASGE::RenderBatches& ASGE::GLStaticSpriteLayer::getBatches() const noexcept
+{
+  return batches;
+}
+
+ASGE::RenderQuad ASGE::GLStaticSpriteLayer::generateMetadata(
+  const GLSprite& sprite, const CGLSpriteRenderer& renderer) const
+{
+  RenderQuad quad;
+  quad.texture_id = sprite.asGLTexture()->getID();
+  quad.z_order    = sprite.getGlobalZOrder();
+  quad.shader_id  = sprite.asGLShader() != nullptr ? sprite.asGLShader()->getShaderID()
+                                                   : renderer.getBasicSpriteShaderID();
+  return quad;
+}
+
+/**
+ *  Brings the GPU copy of the layer up to date.
+ *  Dirty sprites have their quads regenerated in place and
+ *  contiguous runs of them are uploaded as a single range. If
+ *  a dirty sprite now belongs in a different batch, the whole
+ *  layer is rebuilt instead. A clean layer does no work at all.
+ *
+ *  @param renderer The renderer used to generate the quads.
+ */
+void ASGE::GLStaticSpriteLayer::refresh(const CGLSpriteRenderer& renderer)
+{
+  if (needs_rebuild)
+  {
+    rebuild(renderer);
+    return;
+  }
+
+  if (dirty.empty())
+  {
+    return;
+  }
+
+  dirty_slots.clear();
+  for (auto index : dirty)
+  {
+    const auto& sprite = *sprites[index];
+    const auto slot    = slots[index];
+    const auto meta    = generateMetadata(sprite, renderer);
+    const auto& quad   = quads[slot];
+
+    if (
+      meta.texture_id != quad.texture_id || meta.shader_id != quad.shader_id ||
+      meta.z_order != quad.z_order)
+    {
+      rebuild(renderer);
+      return;
+    }
+
+    renderer.quadGen(sprite, payloads[slot]);
+    dirty_slots.emplace_back(slot);
+  }
+
+  std::sort(dirty_slots.begin(), dirty_slots.end());
+  dirty_slots.erase(std::unique(dirty_slots.begin(), dirty_slots.end()), dirty_slots.end());
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  for (auto run_begin = dirty_slots.begin(); run_begin != dirty_slots.end();)
+  {
+    auto run_end = std::next(run_begin);
+    while (run_end != dirty_slots.end() && *run_end == *std::prev(run_end) + 1)
+    {
+      ++run_end;
+    }
+
+    const auto first = *run_begin;
+    const auto count = static_cast<GLsizeiptr>(std::distance(run_begin, run_end));
+    glBufferSubData(
+      GL_COPY_WRITE_BUFFER,
+      QUAD_STORAGE_SIZE * static_cast<GLsizeiptr>(first),
+      QUAD_STORAGE_SIZE * count,
+      &payloads[first]);
+
+    run_begin = run_end;
+  }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  dirty.clear();
+}
+
+/**
+ *  Sorts, batches and uploads the entire layer.
+ *  Sprites are ordered back to front and then by texture, the
+ *  same as the sprite batch's default sort mode, so that they
+ *  can be drawn in as few batches as possible.
+ *
+ *  @param renderer The renderer used to generate the quads.
+ */
+void ASGE::GLStaticSpriteLayer::rebuild(const CGLSpriteRenderer& renderer)
+{
+  const auto count = sprites.size();
+
+  std::vector<QuadSortKey> keys(count);
+  std::vector<QuadSortKey> scratch;
+  quads.resize(count);
+  for (std::uint32_t i = 0; i < count; ++i)
+  {
+    quads[i]             = generateMetadata(*sprites[i], renderer);
+    quads[i].payload_idx = i;
+    keys[i]              = {
+      packQuadSortKey(SpriteSortMode::BACK_TO_FRONT, quads[i].z_order, quads[i].texture_id), i
+    };
+  }
+
+  radixSortQuadKeys(keys, scratch);
+
+  QuadList sorted(count);
+  slots.resize(count);
+  payloads.resize(count);
+  for (std::uint32_t slot = 0; slot < count; ++slot)
+  {
+    sorted[slot]                    = quads[keys[slot].index];
+    slots[sorted[slot].payload_idx] = slot;
+    renderer.quadGen(*sprites[sorted[slot].payload_idx], payloads[slot]);
+  }
+  quads.swap(sorted);
+
+  batches.clear();
+  for (std::uint32_t slot = 0; slot < count; ++slot)
+  {
+    if (
+      batches.empty() || batches.back().textures.ids[0] != quads[slot].texture_id ||
+      batches.back().shader_id != quads[slot].shader_id)
+    {
+      auto& batch           = batches.emplace_back();
+      batch.start_idx       = slot;
+      batch.textures.ids[0] = quads[slot].texture_id;
+      batch.textures.count  = 1;
+      batch.shader_id       = quads[slot].shader_id;
+    }
+    ++batches.back().instance_count;
+  }
+
+  // never empty, so the buffer always has a data store to bind
+  buffer_size           = QUAD_STORAGE_SIZE * static_cast<GLsizeiptr>(count);
+  const auto allocation = std::max<GLsizeiptr>(buffer_size, QUAD_STORAGE_SIZE);
+
+  if (buffer == 0)
+  {
+    glGenBuffers(1, &buffer);
+  }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  glBufferData(GL_COPY_WRITE_BUFFER, allocation, nullptr, GL_STATIC_DRAW);
+  if (buffer_size != 0)
+  {
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, buffer_size, payloads.data());
+  }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  dirty.clear();
+  needs_rebuild = false;
+}
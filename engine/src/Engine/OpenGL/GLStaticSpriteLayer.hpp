@@ -0,0 +1,72 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#ifndef ASGE_GLSTATICSPRITELAYER_HPP
+#define ASGE_GLSTATICSPRITELAYER_HPP
+
+#include "GLIncludes.hpp"
+#include "GLQuad.hpp"
+#include "GLRenderBatch.hpp"
+#include "StaticSpriteLayer.hpp"
+#include <vector>
+
+namespace ASGE
+{
+  class CGLSpriteRenderer;
+  class GLSprite;
+
+  /**
+   * The OpenGL implementation of a StaticSpriteLayer. The layer's
+   * quads are stored in its own buffer, sorted and batched when the
+   * layer is built. Marking a sprite as dirty regenerates its quad in
+   * place, only rebuilding the layer if its texture, shader or z-order
+   * changed as these affect the sort order.
+   */
+  class GLStaticSpriteLayer final : public StaticSpriteLayer
+  {
+   public:
+    GLStaticSpriteLayer() = default;
+    ~GLStaticSpriteLayer() override;
+
+    GLStaticSpriteLayer(const GLStaticSpriteLayer&) = delete;
+    GLStaticSpriteLayer& operator=(const GLStaticSpriteLayer&) = delete;
+
+    std::size_t add(const Sprite& sprite) override;
+    void markDirty(std::size_t index) override;
+    void markAllDirty() override;
+    void clear() override;
+    [[nodiscard]] std::size_t size() const noexcept override;
+
+    void refresh(const CGLSpriteRenderer& renderer);
+    [[nodiscard]] GLuint getBuffer() const noexcept;
+    [[nodiscard]] GLsizeiptr getBufferSize() const noexcept;
+    [[nodiscard]] const RenderBatches& getBatches() const noexcept;
+
+   private:
+    void rebuild(const CGLSpriteRenderer& renderer);
+    [[nodiscard]] RenderQuad
+    generateMetadata(const GLSprite& sprite, const CGLSpriteRenderer& renderer) const;
+
+    std::vector<const GLSprite*> sprites{};
+    std::vector<GLuint> slots{};        // sprite index -> position in the buffer
+    QuadList quads{};                   // in buffer order, payload_idx is the sprite index
+    GPUQuadList payloads{};             // in buffer order
+    std::vector<std::size_t> dirty{};
+    std::vector<GLuint> dirty_slots{};  // scratch for refresh, kept to reuse its storage
+    RenderBatches batches{};
+    GLuint buffer          = 0;
+    GLsizeiptr buffer_size = 0;
+    bool needs_rebuild     = true;
+  };
+}  // namespace ASGE
+
+#endif // ASGE_GLSTATICSPRITELAYER_HPP
@@ -15,6 +15,8 @@
 #include "GLFormat.hpp"
 #include "GLIncludes.hpp"
 #include "GLPixelBuffer.hpp"
+#include "GLRenderer.hpp"
+#include "GLStateCache.hpp"
 
 ASGE::GLTexture::GLTexture(int width, int height) : Texture2D(width, height) {}
 
@@ -25,8 +27,43 @@ ASGE::GLTexture::~GLTexture()
 
 bool ASGE::GLTexture::unload()
 {
-	glDeleteTextures(1, &id);
-	return false;
+  // atlassed textures share their page's texture
+  if (atlas_region.page == nullptr)
+  {
+    GLStateCache::getInstance().forgetTexture(id);
+    glDeleteTextures(1, &id);
+  }
+  return false;
+}
+
+/**
+ *  Marks the texture as a view into an atlas page.
+ *  The texture takes on the page's GL texture, but keeps its
+ *  own dimensions so that source rectangles are unaffected.
+ *
+ *  @param region The page and the texture's offset within it.
+ */
+void ASGE::GLTexture::setAtlasRegion(const AtlasRegion& region) noexcept
+{
+  atlas_region = region;
+  id           = region.page->getID();
+}
+
+const ASGE::GLTexture::AtlasRegion& ASGE::GLTexture::getAtlasRegion() const noexcept
+{
+  return atlas_region;
+}
+
+/**
+ *  Whether textures are created and edited with direct state access.
+ *  The modern renderer requires GL 4.5, so its textures never need
+ *  binding outside of drawing. The legacy renderer binds to edit.
+ *
+ *  @return True if the DSA functions should be used.
+ */
+bool ASGE::GLTexture::useDSA() noexcept
+{
+  return GLRenderer::RENDER_LIB == GLRenderer::RenderLib::GL_MODERN;
 }
 
 const unsigned int& ASGE::GLTexture::getID() const
@@ -70,8 +107,13 @@ void ASGE::GLTexture::updateMagFilter(ASGE::Texture2D::MagFilter filter)
     return;
   }
 
-  GLVCMD(glActiveTexture, GL_TEXTURE0);
-  GLVCMD(glBindTexture ,GL_TEXTURE_2D,getID());
+  if (useDSA())
+  {
+    GLVMSG("Setting Mag Filter", glTextureParameteri, id, GL_TEXTURE_MAG_FILTER, GL_MAG_LOOKUP.at(filter));
+    return;
+  }
+
+  GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_2D, getID());
   GLVMSG(
     "Setting Mag Filter",
     glTexParameteri,
@@ -89,21 +131,39 @@ void ASGE::GLTexture::updateMips()
     return;
   }
 
-  GLVCMD(glActiveTexture, GL_TEXTURE0);
-  GLVCMD(glBindTexture, GL_TEXTURE_2D, getID());
+  if (useDSA())
+  {
+    GLVMSG("Rebuilding Mips", glGenerateTextureMipmap, id);
+    return;
+  }
+
+  GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_2D, getID());
   GLVMSG("Rebuilding Mips", glGenerateMipmap, GL_TEXTURE_2D);
 }
 
 void ASGE::GLTexture::updateUVWrapping(Texture2D::UVWrapMode s, Texture2D::UVWrapMode t)
 {
+  if (useDSA())
+  {
+    glTextureParameteri(id, GL_TEXTURE_WRAP_S, GLTexture::GL_UVWRAP_LOOKUP.at(s));
+    glTextureParameteri(id, GL_TEXTURE_WRAP_T, GLTexture::GL_UVWRAP_LOOKUP.at(t));
+    return;
+  }
+
+  GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_2D, getID());
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GLTexture::GL_UVWRAP_LOOKUP.at(s));
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GLTexture::GL_UVWRAP_LOOKUP.at(t));
 }
 
 void ASGE::GLTexture::updateMinFilter(ASGE::Texture2D::MinFilter filter)
 {
-  GLVCMD(glActiveTexture, GL_TEXTURE0);
-  GLVCMD(glBindTexture ,GL_TEXTURE_2D,getID());
+  if (useDSA())
+  {
+    GLVMSG("Setting Min Filter", glTextureParameteri, id, GL_TEXTURE_MIN_FILTER, GL_MIN_LOOKUP.at(filter));
+    return;
+  }
+
+  GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_2D, getID());
   GLVMSG(
     "Setting Mag Filter",
     glTexParameteri,
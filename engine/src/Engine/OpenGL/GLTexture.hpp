@@ -43,6 +43,18 @@ namespace ASGE
     };
 
    public:
+    /**
+     * Where a texture has been packed into a shared atlas page.
+     * The texture shares the page's GL texture, so its UVs need
+     * to be remapped into the region when they're generated.
+     */
+    struct AtlasRegion
+    {
+      const GLTexture* page = nullptr;
+      float x = 0;
+      float y = 0;
+    };
+
     GLTexture(int width, int height);
     ~GLTexture() override;
     GLTexture(const GLTexture&) = delete;
@@ -58,9 +70,14 @@ namespace ASGE
     void updateMips() override;
     void updateUVWrapping(Texture2D::UVWrapMode s, Texture2D::UVWrapMode t) override;
 
+    void setAtlasRegion(const AtlasRegion& region) noexcept;
+    [[nodiscard]] const AtlasRegion& getAtlasRegion() const noexcept;
+    [[nodiscard]] static bool useDSA() noexcept;
+
    private:
     bool unload();
     unsigned int id{};
+    AtlasRegion atlas_region{};
     mutable std::unique_ptr<GLPixelBuffer> buffer = nullptr;
   };
 }
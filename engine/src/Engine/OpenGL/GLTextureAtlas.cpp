@@ -0,0 +1,317 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLTextureAtlas.hpp"
+#include "GLIncludes.hpp"
+#include "GLStateCache.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+  constexpr int RGBA_CHANNELS = 4;
+
+  /**
+   * Expands the texels to RGBA the same way GL would for the source
+   * format, extruding the edge texels out into the padding.
+   */
+  std::vector<std::uint8_t> padToRGBA(int width, int height, int channels, const void* data)
+  {
+    constexpr int PAD   = ASGE::GLTextureAtlas::PADDING;
+    const int padded_w  = width + 2 * PAD;
+    const int padded_h  = height + 2 * PAD;
+    const auto* texels  = static_cast<const std::uint8_t*>(data);
+
+    std::vector<std::uint8_t> rgba(static_cast<std::size_t>(padded_w * padded_h * RGBA_CHANNELS));
+    for (int y = 0; y < padded_h; ++y)
+    {
+      const int src_y = std::clamp(y - PAD, 0, height - 1);
+      for (int x = 0; x < padded_w; ++x)
+      {
+        const int src_x = std::clamp(x - PAD, 0, width - 1);
+        const auto* src = texels + (src_y * width + src_x) * channels;
+        auto* dst       = &rgba[static_cast<std::size_t>((y * padded_w + x) * RGBA_CHANNELS)];
+
+        switch (channels)
+        {
+          case ASGE::Texture2D::MONOCHROME:
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = 255;
+            break;
+          case ASGE::Texture2D::MONOCHROME_ALPHA:
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = src[1];
+            break;
+          case ASGE::Texture2D::RGB:
+            std::copy_n(src, 3, dst);
+            dst[3] = 255;
+            break;
+          default:
+            std::copy_n(src, RGBA_CHANNELS, dst);
+        }
+      }
+    }
+
+    return rgba;
+  }
+}  // namespace
+
+/**
+ *  Enables the atlas for textures up to the given dimension.
+ *  The page size is limited by the largest texture the driver
+ *  supports, so this must be called with a valid GL context.
+ *
+ *  @param max_dimension The largest width or height to pack, 0 disables.
+ */
+void ASGE::GLTextureAtlas::setThreshold(int max_dimension)
+{
+  GLint max_texture_size = MAX_PAGE_SIZE;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+
+  page_size = std::min(MAX_PAGE_SIZE, max_texture_size);
+  threshold = std::max(max_dimension, 0);
+}
+
+bool ASGE::GLTextureAtlas::accepts(int width, int height) const noexcept
+{
+  return threshold > 0 && width > 0 && height > 0 && width <= threshold &&
+         height <= threshold && std::max(width, height) + 2 * PADDING <= page_size;
+}
+
+int ASGE::GLTextureAtlas::getPageSize() const noexcept
+{
+  return page_size;
+}
+
+/**
+ *  Packs a texture into the first page with room for it.
+ *  The texels are converted to RGBA and uploaded along with their
+ *  gutter, after which the page's mips are rebuilt.
+ *
+ *  @param width The width of the texture.
+ *  @param height The height of the texture.
+ *  @param format The pixel format of the data.
+ *  @param data The texels to pack.
+ *  @return A view onto the page, or nullptr if no page has room.
+ */
+ASGE::GLTexture* ASGE::GLTextureAtlas::insert(
+  int width, int height, Texture2D::Format format, const void* data)
+{
+  const int padded_w = width + 2 * PADDING;
+  const int padded_h = height + 2 * PADDING;
+
+  for (auto& page : pages)
+  {
+    int x = 0;
+    int y = 0;
+    if (!page.pack(padded_w, padded_h, page_size, x, y))
+    {
+      continue;
+    }
+
+    const auto rgba = padToRGBA(width, height, format, data);
+    if (GLTexture::useDSA())
+    {
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTextureSubImage2D(
+        page.texture->getID(), 0, x, y, padded_w, padded_h, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      glGenerateTextureMipmap(page.texture->getID());
+    }
+    else
+    {
+      GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, page.texture->getID());
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexSubImage2D(
+        GL_TEXTURE_2D, 0, x, y, padded_w, padded_h, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      glGenerateMipmap(GL_TEXTURE_2D);
+      GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, 0);
+    }
+    ClearGLErrors(__PRETTY_FUNCTION__);
+
+    auto* texture = new GLTexture(width, height);
+    texture->setFormat(Texture2D::RGBA);
+    texture->setAtlasRegion(
+      { page.texture.get(), static_cast<float>(x + PADDING), static_cast<float>(y + PADDING) });
+
+    ++texture_count;
+    return texture;
+  }
+
+  return nullptr;
+}
+
+/**
+ *  Adds an empty page for textures to spill over onto.
+ *  The atlas takes ownership of the page's texture.
+ *
+ *  @param page A page sized RGBA texture.
+ */
+void ASGE::GLTextureAtlas::addPage(GLTexture* page)
+{
+  if (!pages.empty())
+  {
+    Logging::INFO(
+      "Texture atlas spilling onto page " + std::to_string(pages.size() + 1) + ", " +
+      std::to_string(static_cast<int>(getOccupancy() * 100)) + "% of " +
+      std::to_string(pages.size()) + " page(s) occupied by " + std::to_string(texture_count) +
+      " textures");
+  }
+
+  auto& added = pages.emplace_back();
+  added.texture.reset(page);
+  added.skyline.push_back({ 0, 0, page_size });
+}
+
+/**
+ *  Releases every page. Any views onto the pages must have
+ *  been released before the atlas is reset.
+ */
+void ASGE::GLTextureAtlas::reset()
+{
+  pages.clear();
+  texture_count = 0;
+}
+
+std::size_t ASGE::GLTextureAtlas::getPageCount() const noexcept
+{
+  return pages.size();
+}
+
+std::size_t ASGE::GLTextureAtlas::getTextureCount() const noexcept
+{
+  return texture_count;
+}
+
+/**
+ *  Retrieves how much of the atlas is in use.
+ *  @return The fraction of the allocated pages' area that is packed.
+ */
+float ASGE::GLTextureAtlas::getOccupancy() const noexcept
+{
+  if (pages.empty())
+  {
+    return 0.0F;
+  }
+
+  std::size_t used = 0;
+  for (const auto& page : pages)
+  {
+    used += page.used_area;
+  }
+
+  const auto page_area = static_cast<std::size_t>(page_size) * static_cast<std::size_t>(page_size);
+  return static_cast<float>(used) / static_cast<float>(page_area * pages.size());
+}
+
+/**
+ *  Finds the lowest position along the skyline for a rectangle.
+ *  Ties are broken by choosing the narrowest segment, which keeps
+ *  the wider gaps free for larger textures.
+ *
+ *  @param[in] width The width of the rectangle.
+ *  @param[in] height The height of the rectangle.
+ *  @param[in] size The dimensions of the page.
+ *  @param[out] x The x position of the packed rectangle.
+ *  @param[out] y The y position of the packed rectangle.
+ *  @return True if the rectangle was packed.
+ */
+bool ASGE::GLTextureAtlas::Page::pack(int width, int height, int size, int& x, int& y)
+{
+  auto best_index  = skyline.size();
+  int best_bottom  = std::numeric_limits<int>::max();
+  int best_width   = std::numeric_limits<int>::max();
+
+  for (std::size_t i = 0; i < skyline.size(); ++i)
+  {
+    int top = 0;
+    if (!fits(i, width, height, size, top))
+    {
+      continue;
+    }
+
+    if (top + height < best_bottom || (top + height == best_bottom && skyline[i].width < best_width))
+    {
+      best_index  = i;
+      best_bottom = top + height;
+      best_width  = skyline[i].width;
+      x           = skyline[i].x;
+      y           = top;
+    }
+  }
+
+  if (best_index == skyline.size())
+  {
+    return false;
+  }
+
+  // raise the skyline over the rectangle and trim the segments it covers
+  skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(best_index), { x, y + height, width });
+  for (auto i = best_index + 1; i < skyline.size();)
+  {
+    const auto previous_end = skyline[i - 1].x + skyline[i - 1].width;
+    if (skyline[i].x >= previous_end)
+    {
+      break;
+    }
+
+    const auto overlap = previous_end - skyline[i].x;
+    skyline[i].x += overlap;
+    skyline[i].width -= overlap;
+    if (skyline[i].width > 0)
+    {
+      break;
+    }
+
+    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+  }
+
+  // merge neighbouring segments at the same height
+  for (std::size_t i = 0; i + 1 < skyline.size();)
+  {
+    if (skyline[i].y == skyline[i + 1].y)
+    {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+      continue;
+    }
+    ++i;
+  }
+
+  used_area += static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+  return true;
+}
+
+bool ASGE::GLTextureAtlas::Page::fits(
+  std::size_t index, int width, int height, int size, int& y) const
+{
+  if (skyline[index].x + width > size)
+  {
+    return false;
+  }
+
+  y = skyline[index].y;
+  for (auto remaining = width; remaining > 0; ++index)
+  {
+    y = std::max(y, skyline[index].y);
+    if (y + height > size)
+    {
+      return false;
+    }
+    remaining -= skyline[index].width;
+  }
+
+  return true;
+}
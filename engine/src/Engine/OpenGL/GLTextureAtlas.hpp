@@ -0,0 +1,79 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#pragma once
+
+#include "GLTexture.hpp"
+#include <memory>
+#include <vector>
+
+namespace ASGE
+{
+  /**
+   * Packs small textures into shared atlas pages at runtime.
+   * Sprites using textures from the same page can be drawn in the
+   * same batch. Each packed texture is returned as a view onto its
+   * page, which remaps the sprite's UVs when its quad is generated.
+   * Textures are placed using a bottom-left skyline packer and are
+   * surrounded by a gutter of extruded edge pixels to stop filtering
+   * bleeding across neighbours. When a page fills up, packing spills
+   * over onto a new page.
+   */
+  class GLTextureAtlas
+  {
+   public:
+    static constexpr int MAX_PAGE_SIZE = 2048;
+    static constexpr int PADDING       = 2;
+
+    GLTextureAtlas() = default;
+    ~GLTextureAtlas() = default;
+
+    GLTextureAtlas(const GLTextureAtlas&) = delete;
+    GLTextureAtlas& operator=(const GLTextureAtlas&) = delete;
+
+    void setThreshold(int max_dimension);
+    [[nodiscard]] bool accepts(int width, int height) const noexcept;
+    [[nodiscard]] int getPageSize() const noexcept;
+
+    GLTexture* insert(int width, int height, Texture2D::Format format, const void* data);
+    void addPage(GLTexture* page);
+    void reset();
+
+    [[nodiscard]] std::size_t getPageCount() const noexcept;
+    [[nodiscard]] std::size_t getTextureCount() const noexcept;
+    [[nodiscard]] float getOccupancy() const noexcept;
+
+   private:
+    /// a horizontal segment of the packed area's top edge
+    struct SkylineNode
+    {
+      int x     = 0;
+      int y     = 0;
+      int width = 0;
+    };
+
+    struct Page
+    {
+      std::unique_ptr<GLTexture> texture{};
+      std::vector<SkylineNode> skyline{};
+      std::size_t used_area = 0;
+
+      bool pack(int width, int height, int size, int& x, int& y);
+      [[nodiscard]] bool fits(std::size_t index, int width, int height, int size, int& y) const;
+    };
+
+    std::vector<Page> pages{};
+    std::size_t texture_count = 0;
+    int threshold             = 0;
+    int page_size             = MAX_PAGE_SIZE;
+  };
+}  // namespace ASGE
@@ -12,6 +12,7 @@
 
 // STB
 #define STB_IMAGE_IMPLEMENTATION
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <stb_image.h>
@@ -21,9 +22,20 @@
 #include "GLFormat.hpp"
 #include "GLIncludes.hpp"
 #include "GLRenderer.hpp"
+#include "GLStateCache.hpp"
 #include "GLTexture.hpp"
 #include "GLTextureCache.hpp"
 
+namespace
+{
+  // the number of levels in a full mip chain
+  GLsizei mipLevels(int width, int height)
+  {
+    const auto largest = static_cast<float>(std::max(std::max(width, height), 1));
+    return static_cast<GLsizei>(std::floor(std::log2(largest))) + 1;
+  }
+}  // namespace
+
 ASGE::GLTextureCache::~GLTextureCache()
 {
 	reset();
@@ -39,6 +51,20 @@ void ASGE::GLTextureCache::reset()
 		}
 	}
 	cache.clear();
+	atlas.reset();
+	debug_texture = nullptr;
+}
+
+/**
+ *  The texture sprites show until they're given one of their own.
+ *  Kept aside when the renderer creates it, so sprites don't need
+ *  to look it up by name.
+ *
+ *  @return The debug texture, or nullptr before the renderer is ready.
+ */
+ASGE::GLTexture* ASGE::GLTextureCache::debugTexture() const noexcept
+{
+  return debug_texture;
 }
 
 ASGE::GLTexture* ASGE::GLTextureCache::createCached(const std::string& path)
@@ -49,7 +75,7 @@ ASGE::GLTexture* ASGE::GLTextureCache::createCached(const std::string& path)
     return cached_texture.get();
   }
 
-  cache[path] = std::unique_ptr<ASGE::GLTexture> { allocateTexture(path) };
+  cache[path] = std::unique_ptr<ASGE::GLTexture> { allocateTexture(path, true) };
   return cache[path].get();
 }
 
@@ -87,7 +113,7 @@ ASGE::GLTexture* ASGE::GLTextureCache::createNonCachedMSAA(int img_width, int im
   return allocateMSAATexture(img_width, img_height, format);
 }
 
-ASGE::GLTexture* ASGE::GLTextureCache::allocateTexture(const std::string& file)
+ASGE::GLTexture* ASGE::GLTextureCache::allocateTexture(const std::string& file, bool allow_atlas)
 {
   int   img_width  = 0;
   int   img_height = 0;
@@ -119,12 +145,28 @@ ASGE::GLTexture* ASGE::GLTextureCache::allocateTexture(const std::string& file)
   }
 
   auto format = ASGE::Texture2D::Format{ static_cast<ASGE::Texture2D::Format>(bpp) };
-  auto* texture = allocateTexture(img_width, img_height, format, image);
+  auto* texture = allow_atlas && atlas.accepts(img_width, img_height)
+                    ? allocateAtlasTexture(img_width, img_height, format, image)
+                    : allocateTexture(img_width, img_height, format, image);
 
   stbi_image_free(image);
   return texture;
 }
 
+ASGE::GLTexture* ASGE::GLTextureCache::allocateAtlasTexture(
+  int img_width, int img_height, Texture2D::Format format, const void* data)
+{
+  if (auto* texture = atlas.insert(img_width, img_height, format, data))
+  {
+    return texture;
+  }
+
+  // no room left on the existing pages, so spill onto a new one
+  const auto page_size = atlas.getPageSize();
+  atlas.addPage(allocateTexture(page_size, page_size, Texture2D::RGBA, nullptr));
+  return atlas.insert(img_width, img_height, format, data);
+}
+
 ASGE::GLTexture*
 ASGE::GLTextureCache::allocateTexture(
   int img_width, int img_height, Texture2D::Format format, const void* data)
@@ -132,9 +174,40 @@ ASGE::GLTextureCache::allocateTexture(
   auto *texture = new GLTexture(img_width, img_height);
   texture->setFormat(format);
 
+  if (GLTexture::useDSA())
+  {
+    // immutable storage, so reserve every mip level the texture could need
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture->getID());
+    glTextureStorage2D(texture->getID(), mipLevels(img_width, img_height), GL_RGBA8, img_width, img_height);
+
+    if (data != nullptr)
+    {
+      glTextureSubImage2D(
+        texture->getID(),
+        0,
+        0, 0,
+        img_width, img_height,
+        GLFORMAT[texture->getFormat()],
+        GL_UNSIGNED_BYTE,
+        data);
+      glGenerateTextureMipmap(texture->getID());
+    }
+
+    glTextureParameteri(texture->getID(), GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture->getID(), GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture->getID(), GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(
+      texture->getID(), GL_TEXTURE_MAG_FILTER, GLTexture::GL_MAG_LOOKUP.at(renderer->magFilter()));
+
+    float aniso_level = 16;
+    glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &aniso_level);
+    glTextureParameterf(texture->getID(), GL_TEXTURE_MAX_ANISOTROPY, aniso_level);
+    return texture;
+  }
+
   // Allocate a texture
   glGenTextures(1, &texture->getID());
-  glBindTexture(GL_TEXTURE_2D, texture->getID());
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, texture->getID());
 
   // Load the 2D texture
   glTexImage2D(
@@ -170,7 +243,7 @@ ASGE::GLTextureCache::allocateTexture(
     glTextureParameterf(texture->getID(), GL_TEXTURE_MAX_ANISOTROPY, aniso_level);
   }
 
-  glBindTexture(GL_TEXTURE_2D, 0);
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D, 0);
   return texture;
 }
 
@@ -179,11 +252,19 @@ ASGE::GLTexture* ASGE::GLTextureCache::allocateMSAATexture(int img_width, int im
   auto *texture = new GLTexture(img_width, img_height);
   texture->setFormat(format);
 
+  if (GLTexture::useDSA())
+  {
+    glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &texture->getID());
+    glTextureStorage2DMultisample(
+      texture->getID(), renderer->msaa(), GLSIZEDFORMAT[texture->getFormat()], img_width, img_height, GL_TRUE);
+    return texture;
+  }
+
   // Allocate a texture
   glGenTextures(1, &texture->getID());
-  glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture->getID());
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture->getID());
   glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, renderer->msaa(), GLFORMAT[texture->getFormat()], img_width, img_height, GL_TRUE);
-  glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
   return texture;
 }
 
@@ -193,8 +274,27 @@ ASGE::GLTexture* ASGE::GLTextureCache::allocateTextureArray(
   auto *texture = new GLTexture(img_width, img_height);
   texture->setFormat(format);
 
+  if (GLTexture::useDSA())
+  {
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture->getID());
+    glTextureStorage3D(texture->getID(), 1, GL_RGBA8, img_width, img_height, count);
+    glTextureSubImage3D(
+      texture->getID(),
+      0, 0, 0, 0, img_width, img_height, count, GLFORMAT[texture->getFormat()],
+      GL_UNSIGNED_BYTE, data);
+
+    glTextureParameteri(texture->getID(), GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture->getID(), GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture->getID(), GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(
+      texture->getID(), GL_TEXTURE_MAG_FILTER, GLTexture::GL_MAG_LOOKUP.at(renderer->magFilter()));
+
+    ASGE::ClearGLErrors("Error: Allocating texture array!");
+    return texture;
+  }
+
   glGenTextures(1, &texture->getID());
-  glBindTexture(GL_TEXTURE_2D_ARRAY, texture->getID());
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D_ARRAY, texture->getID());
 
   // Load the 2D texture
   glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, img_width, img_height, count);
@@ -218,7 +318,7 @@ ASGE::GLTexture* ASGE::GLTextureCache::allocateTextureArray(
     glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
   }
 
-  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+  GLStateCache::getInstance().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
   ASGE::ClearGLErrors("Error: Allocating texture array!");
   return texture;
@@ -16,6 +16,7 @@
 #include <memory>
 #include <string>
 #include "GLTexture.hpp"
+#include "GLTextureAtlas.hpp"
 #include "NonCopyable.hpp"
 
 namespace ASGE
@@ -38,6 +39,7 @@ namespace ASGE
     ASGE::GLTexture* createNonCached(const std::string& path);
     ASGE::GLTexture* createNonCachedMSAA(int img_width, int img_height, Texture2D::Format format);
     ASGE::GLTexture* createCached(const std::string& uid, int img_width, int img_height, GLTexture::Format format, void* data);
+    [[nodiscard]] ASGE::GLTexture* debugTexture() const noexcept;
     void reset();
 
    private:
@@ -47,10 +49,13 @@ namespace ASGE
     ASGE::GLTexture* allocateMSAATexture(int img_width, int img_height, Texture2D::Format format);
     ASGE::GLTexture* allocateTextureArray(int img_width, int img_height, Texture2D::Format format, const void* data, int count);
     ASGE::GLTexture* allocateTexture(int img_width, int img_height, Texture2D::Format format, const void* data);
-    ASGE::GLTexture* allocateTexture(const std::string& file);
+    ASGE::GLTexture* allocateTexture(const std::string& file, bool allow_atlas = false);
+    ASGE::GLTexture* allocateAtlasTexture(int img_width, int img_height, Texture2D::Format format, const void* data);
 
     // the cache and renderer to use
 		std::map<const std::string, std::unique_ptr<GLTexture>> cache;
+    GLTextureAtlas atlas;
     ASGE::GLRenderer* renderer {nullptr};
+    ASGE::GLTexture* debug_texture {nullptr};
   };
 }  // namespace ASGE
\ No newline at end of file
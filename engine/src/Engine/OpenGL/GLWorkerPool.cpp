@@ -0,0 +1,144 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#include "GLWorkerPool.hpp"
+
+ASGE::GLWorkerPool::~GLWorkerPool()
+{
+  stop();
+}
+
+/**
+ *  Sets the number of threads that run each job.
+ *  The calling thread always takes part, so one fewer thread is
+ *  started. Any existing threads are joined first.
+ *
+ *  @param workers The number of workers, including the calling thread.
+ */
+void ASGE::GLWorkerPool::resize(unsigned int workers)
+{
+  stop();
+  stopping = false;
+
+  const auto count = workers > 1 ? workers - 1 : 0U;
+  threads.reserve(count);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    threads.emplace_back(&GLWorkerPool::work, this, generation);
+  }
+}
+
+/**
+ *  @return The number of workers, including the calling thread.
+ */
+unsigned int ASGE::GLWorkerPool::size() const noexcept
+{
+  return static_cast<unsigned int>(threads.size()) + 1;
+}
+
+/**
+ *  Runs a job and waits for it to finish.
+ *  Without any threads, or with a single task, the tasks are simply
+ *  run in order on the calling thread.
+ *
+ *  @param tasks The number of tasks in the job.
+ *  @param task Called once with each task's index.
+ *  @param context Passed to every call of task.
+ */
+void ASGE::GLWorkerPool::run(std::size_t tasks, Task task, void* context)
+{
+  if (threads.empty() || tasks < 2)
+  {
+    for (std::size_t i = 0; i < tasks; ++i)
+    {
+      task(context, i);
+    }
+    return;
+  }
+
+  {
+    // a late worker may still be reading the last job
+    std::unique_lock lock(mutex);
+    idle.wait(lock, [this] { return busy == 0; });
+    job         = task;
+    job_context = context;
+    job_size    = tasks;
+    next_task.store(0, std::memory_order_relaxed);
+    ++generation;
+  }
+
+  wake.notify_all();
+  execute();
+
+  // every task is handed out, so once no worker is busy all are done
+  std::unique_lock lock(mutex);
+  idle.wait(lock, [this] { return busy == 0; });
+}
+
+/**
+ *  Wakes and joins every thread.
+ */
+void ASGE::GLWorkerPool::stop()
+{
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+
+  wake.notify_all();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  threads.clear();
+}
+
+/**
+ *  A worker's loop, sleeping until there's a new job to help with.
+ *
+ *  @param seen The generation of the last job the worker saw.
+ */
+void ASGE::GLWorkerPool::work(std::uint64_t seen)
+{
+  std::unique_lock lock(mutex);
+  while (true)
+  {
+    wake.wait(lock, [&] { return stopping || generation != seen; });
+    if (stopping)
+    {
+      return;
+    }
+
+    seen = generation;
+    ++busy;
+    lock.unlock();
+    execute();
+    lock.lock();
+
+    if (--busy == 0)
+    {
+      idle.notify_all();
+    }
+  }
+}
+
+/**
+ *  Takes tasks from the current job until there are none left.
+ */
+void ASGE::GLWorkerPool::execute()
+{
+  for (auto i = next_task.fetch_add(1, std::memory_order_relaxed); i < job_size;
+       i      = next_task.fetch_add(1, std::memory_order_relaxed))
+  {
+    job(job_context, i);
+  }
+}
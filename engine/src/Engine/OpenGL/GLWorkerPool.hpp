@@ -0,0 +1,84 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+#ifndef ASGE_GLWORKERPOOL_HPP
+#define ASGE_GLWORKERPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ASGE
+{
+  /**
+   * A fixed set of threads that the batch splits its work across.
+   * The threads are started once, when the worker count is set, and
+   * sleep between jobs. A job is a number of tasks, handed out to the
+   * calling thread and the workers until none remain, and run only
+   * returns once every task has finished. Jobs are passed as a plain
+   * function and context, so dispatching one never allocates.
+   */
+  class GLWorkerPool
+  {
+   public:
+    using Task = void (*)(void* context, std::size_t task);
+
+    GLWorkerPool() = default;
+    ~GLWorkerPool();
+
+    GLWorkerPool(const GLWorkerPool&) = delete;
+    GLWorkerPool& operator=(const GLWorkerPool&) = delete;
+
+    void resize(unsigned int workers);
+    [[nodiscard]] unsigned int size() const noexcept;
+    void run(std::size_t tasks, Task task, void* context);
+
+    /**
+     * Runs a callable once per task, see run.
+     * @param tasks The number of tasks.
+     * @param callable Called with each task's index, from any thread.
+     */
+    template<typename Callable>
+    void forEach(std::size_t tasks, Callable& callable)
+    {
+      run(
+        tasks,
+        [](void* context, std::size_t task) { (*static_cast<Callable*>(context))(task); },
+        &callable);
+    }
+
+   private:
+    void stop();
+    void work(std::uint64_t seen);
+    void execute();
+
+    std::vector<std::thread> threads{};
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    std::condition_variable idle{};
+
+    // written under the mutex, before the generation moves on
+    Task job             = nullptr;
+    void* job_context    = nullptr;
+    std::size_t job_size = 0;
+    std::atomic<std::size_t> next_task{ 0 };
+    std::uint64_t generation = 0;
+    unsigned int busy        = 0;
+    bool stopping            = false;
+  };
+}  // namespace ASGE
+
+#endif // ASGE_GLWORKERPOOL_HPP
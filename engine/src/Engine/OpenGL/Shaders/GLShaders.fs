@@ -53,18 +53,44 @@ const std::string fs_instancing =
 R"(
 #version 330 core
 #define FRAG_COLOUR     0
+#define MAX_TEXTURE_SLOTS 16
 in VertexData
 {
     vec2    uvs;
     vec4    rgba;
 } fs_in;
 
-uniform sampler2D image;
+flat in uint texture_slot;
+uniform sampler2D images[MAX_TEXTURE_SLOTS];
 layout  (location = FRAG_COLOUR, index = 0) out vec4 FragColor;
 
+// GLSL 3.30 only allows sampler arrays to be indexed by constants
+vec4 sampleSlot(uint slot, vec2 uvs)
+{
+    switch (slot)
+    {
+        case  1u: return texture(images[1],  uvs);
+        case  2u: return texture(images[2],  uvs);
+        case  3u: return texture(images[3],  uvs);
+        case  4u: return texture(images[4],  uvs);
+        case  5u: return texture(images[5],  uvs);
+        case  6u: return texture(images[6],  uvs);
+        case  7u: return texture(images[7],  uvs);
+        case  8u: return texture(images[8],  uvs);
+        case  9u: return texture(images[9],  uvs);
+        case 10u: return texture(images[10], uvs);
+        case 11u: return texture(images[11], uvs);
+        case 12u: return texture(images[12], uvs);
+        case 13u: return texture(images[13], uvs);
+        case 14u: return texture(images[14], uvs);
+        case 15u: return texture(images[15], uvs);
+        default:  return texture(images[0],  uvs);
+    }
+}
+
 void main()
 {
-    FragColor = fs_in.rgba * texture(image, fs_in.uvs);
+    FragColor = fs_in.rgba * sampleSlot(texture_slot, fs_in.uvs);
     //FragColor = vec4(vec3(gl_FragCoord.z), 1.0);
 }
 )";
\ No newline at end of file
@@ -3,13 +3,16 @@ R"(
 #version 430 core
 
 struct Quad {
-  mat4 model_matrix;
-  vec4 color;
-  vec4 uv_data[4];
+  vec4 transform;
+  vec4 uv_rect;
+  vec2 translation;
+  uint colour;
+  uint depth_slot;
 };
 
-layout (location = 0) in vec2 position;
-layout (location = 2) uniform int quad_buffer_offset;
+// Sourced from an identity buffer with a divisor of 1, so each
+// instance reads the sorted index at gl_BaseInstance + gl_InstanceID
+layout (location = 1) in uint quad_index;
 
 layout (std140, binding=1) uniform global_shader_data
 {
@@ -21,26 +24,56 @@ layout (std140, binding=10) buffer ssbo_buffer
     Quad quads[];
 };
 
+// The quads are written in submission order, so draws
+// read them through the sorted order instead. Each entry
+// holds the quad's index, with its texture slot above it
+#define QUAD_SLOT_SHIFT 28u
+#define QUAD_INDEX_MASK 0x0FFFFFFFu
+layout (std430, binding=11) readonly buffer order_buffer
+{
+    uint quad_order[];
+};
+
 out VertexData
 {
     vec2    uvs;
     vec4    rgba;
 }  vs_out;
 
+// Which of the batch's textures to sample from
+flat out uint texture_slot;
+
+// The quad's corners, indexed by gl_VertexID
+const vec2 corners[4] = vec2[4](vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0));
+
+vec4 unpackColour(uint rgba)
+{
+    return vec4((uvec4(rgba) >> uvec4(0u, 8u, 16u, 24u)) & 0xFFu) / 255.0;
+}
+
+// The z-order is a signed short packed in the low half
+float unpackDepth(uint depth_slot)
+{
+    return float(int(depth_slot << 16u) >> 16);
+}
+
 void main()
 {
-    // Calculate the offset into the SSBO
-    int instance_offset = gl_InstanceID+quad_buffer_offset;
+    // Fetch the instance's quad from the SSBO
+    uint order  = quad_order[quad_index];
+    Quad quad   = quads[order & QUAD_INDEX_MASK];
+    vec2 corner = corners[gl_VertexID];
 
     // Calculate the final pixel position
-    gl_Position  = projection * (quads[instance_offset].model_matrix * vec4(position.xy, 0.0, 1.0));
+    vec2 world   = mat2(quad.transform.xy, quad.transform.zw) * corner + quad.translation;
+    gl_Position  = projection * vec4(world, unpackDepth(quad.depth_slot), 1.0);
+    texture_slot = order >> QUAD_SLOT_SHIFT;
 
     // Pass the per-instance color through to the fragment shader.
-    vs_out.rgba = quads[instance_offset].color;
+    vs_out.rgba = unpackColour(quad.colour);
 
     // Pass on the texture coordinate mappings
-    vs_out.uvs[0] = quads[instance_offset].uv_data[gl_VertexID][0];
-    vs_out.uvs[1] = quads[instance_offset].uv_data[gl_VertexID][1];
+    vs_out.uvs = mix(quad.uv_rect.xy, quad.uv_rect.zw, corner);
 }
 )";
 
@@ -49,47 +82,77 @@ const std::string vs_instancing_legacy =
 R"(
   #version 330 core
 
-  #define MAX_NUM_TOTAL_QUADS     400
   struct Quad {
-      mat4 model_matrix;   //     64B
-      vec4 color;          //    +32B
-      vec4 uv_data[4];     //    +64B
+      vec4 transform;      //     16B
+      vec4 uv_rect;        //    +16B
+      vec2 translation;    //     +8B
+      uint colour;         //     +4B
+      uint depth_slot;     //     +4B
                            // =======
-                           //    160B
+                           //     48B
   };
 
-  layout (location = 0) in vec2 position;
   uniform int quad_buffer_offset;
 
+  // Each quad is three RGBA32UI texels, floats are stored as their bits
+  uniform usamplerBuffer quad_buffer;
+
   layout (std140) uniform global_shader_data
   {
       mat4 projection;
   };
 
-  layout (std140) uniform render_quads
-  {
-      Quad quads[MAX_NUM_TOTAL_QUADS];
-  };
-
   out VertexData
   {
       vec2    uvs;
       vec4    rgba;
   }  vs_out;
 
+  // Which of the batch's textures to sample from
+  flat out uint texture_slot;
+
+  // The quad's corners, indexed by gl_VertexID
+  const vec2 corners[4] = vec2[4](vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0));
+
+  vec4 unpackColour(uint rgba)
+  {
+      return vec4((uvec4(rgba) >> uvec4(0u, 8u, 16u, 24u)) & 0xFFu) / 255.0;
+  }
+
+  // The z-order is a signed short packed in the low half
+  float unpackDepth(uint depth_slot)
+  {
+      return float(int(depth_slot << 16u) >> 16);
+  }
+
+  Quad fetchQuad(int index)
+  {
+      uvec4 texel = texelFetch(quad_buffer, index * 3 + 2);
+
+      Quad quad;
+      quad.transform   = uintBitsToFloat(texelFetch(quad_buffer, index * 3));
+      quad.uv_rect     = uintBitsToFloat(texelFetch(quad_buffer, index * 3 + 1));
+      quad.translation = uintBitsToFloat(texel.xy);
+      quad.colour      = texel.z;
+      quad.depth_slot  = texel.w;
+      return quad;
+  }
+
   void main()
   {
-    // Calculate the offset into the UBO
-    int instance_offset = gl_InstanceID + quad_buffer_offset;
+    // Calculate the offset into the buffer
+    Quad quad   = fetchQuad(gl_InstanceID + quad_buffer_offset);
+    vec2 corner = corners[gl_VertexID];
 
     // Final position
-    gl_Position  = projection * (quads[instance_offset].model_matrix * vec4(position.xy, 0.0, 1.0));
+    vec2 world   = mat2(quad.transform.xy, quad.transform.zw) * corner + quad.translation;
+    gl_Position  = projection * vec4(world, unpackDepth(quad.depth_slot), 1.0);
+    texture_slot = quad.depth_slot >> 16u;
 
     // Pass the per-instance color through to the fragment shader.
-    vs_out.rgba = quads[instance_offset].color;
+    vs_out.rgba = unpackColour(quad.colour);
 
     // Pass on the texture coordinate mappings
-    vs_out.uvs[0] = quads[instance_offset].uv_data[gl_VertexID][0];
-    vs_out.uvs[1] = quads[instance_offset].uv_data[gl_VertexID][1];
+    vs_out.uvs = mix(quad.uv_rect.xy, quad.uv_rect.zw, corner);
   }
 )";
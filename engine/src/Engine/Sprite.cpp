@@ -22,6 +22,7 @@ float ASGE::Sprite::xPos() const noexcept
 void ASGE::Sprite::xPos(float x) noexcept
 {
   position[0] = x;
+  dirty_flags = ALL_DIRTY;
 }
 
 float ASGE::Sprite::yPos() const noexcept
@@ -32,6 +33,7 @@ float ASGE::Sprite::yPos() const noexcept
 void ASGE::Sprite::yPos(float y) noexcept
 {
   position[1] = y;
+  dirty_flags = ALL_DIRTY;
 }
 
 float ASGE::Sprite::width() const noexcept
@@ -42,6 +44,7 @@ float ASGE::Sprite::width() const noexcept
 void ASGE::Sprite::width(float width) noexcept
 {
   dims[0] = width;
+  dirty_flags = ALL_DIRTY;
 }
 
 float ASGE::Sprite::height() const noexcept
@@ -52,6 +55,7 @@ float ASGE::Sprite::height() const noexcept
 void ASGE::Sprite::height(float height) noexcept
 {
   dims[1] = height;
+  dirty_flags = ALL_DIRTY;
 }
 
 void ASGE::Sprite::dimensions(float& width, float& height) const noexcept
@@ -73,11 +77,13 @@ float ASGE::Sprite::scale() const noexcept
 void ASGE::Sprite::rotationInRadians(float rotation_radians)
 {
   angle = rotation_radians;
+  dirty_flags = ALL_DIRTY;
 }
 
 void ASGE::Sprite::scale(float scale_value) noexcept
 {
   scale_factor = scale_value;
+  dirty_flags = ALL_DIRTY;
 }
 
 ASGE::Colour ASGE::Sprite::colour() const noexcept
@@ -108,6 +114,7 @@ bool ASGE::Sprite::isFlippedOnXY() const noexcept
 void ASGE::Sprite::setFlipFlags(FlipFlags flip) noexcept
 {
   flip_flags = flip;
+  dirty_flags = ALL_DIRTY;
 }
 
 void ASGE::Sprite::opacity(float a) noexcept
@@ -145,7 +152,13 @@ ASGE::SpriteBounds ASGE::Sprite::getLocalBounds() const noexcept
 
 ASGE::SpriteBounds ASGE::Sprite::getWorldBounds() const noexcept
 {
-  SpriteBounds bounds;
+  // the bounds only change when the transform does
+  if (!isDirty(BOUNDS_DIRTY))
+  {
+    return world_bounds;
+  }
+
+  auto& bounds = world_bounds;
 
   //   X = x*cos(θ) - y*sin(θ)
   //   Y = x*sin(θ) + y*cos(θ)
@@ -170,11 +183,11 @@ ASGE::SpriteBounds ASGE::Sprite::getWorldBounds() const noexcept
     return point;
   };
 
-  // TODO optimise this..
   bounds.v1 = rotate(this->xPos(), this->yPos());
   bounds.v2 = rotate(this->xPos() + width() * scale(), this->yPos());
   bounds.v3 = rotate(this->xPos() + width() * scale(), this->yPos() + height() * scale());
   bounds.v4 = rotate(this->xPos(), this->yPos() + height() * scale());
+  clearDirty(BOUNDS_DIRTY);
   return bounds;
 }
 
@@ -227,9 +240,20 @@ void ASGE::Sprite::setMagFilter(ASGE::Texture2D::MagFilter requested_filter) con
 
 std::array<float, 2>& ASGE::Sprite::dimensions()
 {
+  dirty_flags = ALL_DIRTY;
   return dims;
 }
 
+bool ASGE::Sprite::isDirty(DirtyFlags flag) const noexcept
+{
+  return (dirty_flags & flag) != 0;
+}
+
+void ASGE::Sprite::clearDirty(DirtyFlags flag) const noexcept
+{
+  dirty_flags = static_cast<uint8_t>(dirty_flags & ~flag);
+}
+
 std::tuple<int, int> ASGE::Sprite::dimensions() const noexcept
 {
   return std::make_tuple(static_cast<int>(width()), static_cast<int>(height()));
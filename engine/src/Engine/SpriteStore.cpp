@@ -0,0 +1,317 @@
+//  Copyright (c) 2021 James Huxtable. All rights reserved.
+//
+//  This work is licensed under the terms of the MIT license.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//  SOFTWARE.
+
+
+#include "SpriteStore.hpp"
+#include "Texture.hpp"
+#include <algorithm>
+
+ASGE::SpriteHandle ASGE::SpriteStore::create(Texture2D* sprite_texture)
+{
+  std::uint32_t slot = 0;
+  if (!free_slots.empty())
+  {
+    slot = free_slots.back();
+    free_slots.pop_back();
+  }
+  else
+  {
+    slot = static_cast<std::uint32_t>(dense.size());
+    dense.emplace_back();
+    generation.emplace_back(0);
+  }
+
+  const auto tex_width  = sprite_texture != nullptr ? sprite_texture->getWidth() : 0.0F;
+  const auto tex_height = sprite_texture != nullptr ? sprite_texture->getHeight() : 0.0F;
+
+  dense[slot] = static_cast<std::uint32_t>(x.size());
+  x.emplace_back(0.0F);
+  y.emplace_back(0.0F);
+  width.emplace_back(tex_width);
+  height.emplace_back(tex_height);
+  angle.emplace_back(0.0F);
+  scale.emplace_back(1.0F);
+  alpha.emplace_back(1.0F);
+  tint.emplace_back(COLOURS::WHITE);
+  src_rect.push_back({ 0.0F, 0.0F, tex_width, tex_height });
+  texture.emplace_back(sprite_texture);
+  z_order.emplace_back(0);
+  owner.emplace_back(slot);
+
+  return { slot, generation[slot] };
+}
+
+std::vector<ASGE::SpriteHandle> ASGE::SpriteStore::create(std::size_t count, Texture2D* sprite_texture)
+{
+  reserve(size() + count);
+
+  std::vector<SpriteHandle> handles;
+  handles.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    handles.emplace_back(create(sprite_texture));
+  }
+
+  return handles;
+}
+
+/**
+ *  Destroys a sprite by moving the last sprite into its place.
+ *  Only the moved sprite's slot needs updating, so every other
+ *  handle stays valid. The destroyed slot's generation is bumped,
+ *  which invalidates any remaining handles to it.
+ */
+void ASGE::SpriteStore::destroy(SpriteHandle handle)
+{
+  if (!isValid(handle))
+  {
+    return;
+  }
+
+  const auto index = dense[handle.index];
+  const auto last  = x.size() - 1;
+
+  auto remove = [index, last](auto& values) {
+    values[index] = values[last];
+    values.pop_back();
+  };
+
+  remove(x);
+  remove(y);
+  remove(width);
+  remove(height);
+  remove(angle);
+  remove(scale);
+  remove(alpha);
+  remove(tint);
+  remove(src_rect);
+  remove(texture);
+  remove(z_order);
+  remove(owner);
+
+  if (index != last)
+  {
+    dense[owner[index]] = index;
+  }
+
+  ++generation[handle.index];
+  free_slots.emplace_back(handle.index);
+}
+
+void ASGE::SpriteStore::destroy(std::span<const SpriteHandle> handles)
+{
+  for (const auto& handle : handles)
+  {
+    destroy(handle);
+  }
+}
+
+void ASGE::SpriteStore::clear()
+{
+  for (const auto slot_owner : owner)
+  {
+    ++generation[slot_owner];
+    free_slots.emplace_back(slot_owner);
+  }
+
+  x.clear();
+  y.clear();
+  width.clear();
+  height.clear();
+  angle.clear();
+  scale.clear();
+  alpha.clear();
+  tint.clear();
+  src_rect.clear();
+  texture.clear();
+  z_order.clear();
+  owner.clear();
+}
+
+void ASGE::SpriteStore::reserve(std::size_t count)
+{
+  x.reserve(count);
+  y.reserve(count);
+  width.reserve(count);
+  height.reserve(count);
+  angle.reserve(count);
+  scale.reserve(count);
+  alpha.reserve(count);
+  tint.reserve(count);
+  src_rect.reserve(count);
+  texture.reserve(count);
+  z_order.reserve(count);
+  owner.reserve(count);
+}
+
+bool ASGE::SpriteStore::isValid(SpriteHandle handle) const noexcept
+{
+  return handle.index < generation.size() && generation[handle.index] == handle.generation &&
+         dense[handle.index] < x.size() && owner[dense[handle.index]] == handle.index;
+}
+
+std::size_t ASGE::SpriteStore::size() const noexcept
+{
+  return x.size();
+}
+
+/**
+ *  Finds where a sprite's properties are stored.
+ *
+ *  @param handle The sprite to find.
+ *  @return The sprite's index into the packed arrays, or size() if
+ *  the handle is stale.
+ */
+std::size_t ASGE::SpriteStore::denseIndex(SpriteHandle handle) const noexcept
+{
+  return isValid(handle) ? dense[handle.index] : size();
+}
+
+void ASGE::SpriteStore::setPosition(SpriteHandle handle, float pos_x, float pos_y) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    x[i] = pos_x;
+    y[i] = pos_y;
+  }
+}
+
+void ASGE::SpriteStore::setDimensions(SpriteHandle handle, float new_width, float new_height) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    width[i]  = new_width;
+    height[i] = new_height;
+  }
+}
+
+void ASGE::SpriteStore::setRotation(SpriteHandle handle, float radians) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    angle[i] = radians;
+  }
+}
+
+void ASGE::SpriteStore::setScale(SpriteHandle handle, float new_scale) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    scale[i] = new_scale;
+  }
+}
+
+void ASGE::SpriteStore::setColour(SpriteHandle handle, Colour colour) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    tint[i] = colour;
+  }
+}
+
+void ASGE::SpriteStore::setOpacity(SpriteHandle handle, float opacity) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    alpha[i] = opacity;
+  }
+}
+
+void ASGE::SpriteStore::setSrcRect(SpriteHandle handle, const std::array<float, 4>& rect) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    src_rect[i] = rect;
+  }
+}
+
+void ASGE::SpriteStore::setTexture(SpriteHandle handle, Texture2D* new_texture) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    texture[i] = new_texture;
+  }
+}
+
+void ASGE::SpriteStore::setGlobalZOrder(SpriteHandle handle, int16_t new_z_order) noexcept
+{
+  if (const auto i = denseIndex(handle); i < size())
+  {
+    z_order[i] = new_z_order;
+  }
+}
+
+void ASGE::SpriteStore::setPositions(
+  std::span<const SpriteHandle> handles, std::span<const Point2D> positions) noexcept
+{
+  const auto count = std::min(handles.size(), positions.size());
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    if (const auto i = denseIndex(handles[n]); i < size())
+    {
+      x[i] = positions[n].x;
+      y[i] = positions[n].y;
+    }
+  }
+}
+
+void ASGE::SpriteStore::setRotations(
+  std::span<const SpriteHandle> handles, std::span<const float> radians) noexcept
+{
+  const auto count = std::min(handles.size(), radians.size());
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    if (const auto i = denseIndex(handles[n]); i < size())
+    {
+      angle[i] = radians[n];
+    }
+  }
+}
+
+void ASGE::SpriteStore::setOpacities(
+  std::span<const SpriteHandle> handles, std::span<const float> opacities) noexcept
+{
+  const auto count = std::min(handles.size(), opacities.size());
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    if (const auto i = denseIndex(handles[n]); i < size())
+    {
+      alpha[i] = opacities[n];
+    }
+  }
+}
+
+void ASGE::SpriteStore::setGlobalZOrders(std::span<const SpriteHandle> handles, int16_t new_z_order) noexcept
+{
+  for (const auto& handle : handles)
+  {
+    setGlobalZOrder(handle, new_z_order);
+  }
+}
+
+void ASGE::SpriteStore::translate(float dx, float dy) noexcept
+{
+  std::for_each(x.begin(), x.end(), [dx](float& value) { value += dx; });
+  std::for_each(y.begin(), y.end(), [dy](float& value) { value += dy; });
+}
+
+ASGE::Point2D ASGE::SpriteStore::position(SpriteHandle handle) const noexcept
+{
+  const auto i = denseIndex(handle);
+  return i < size() ? Point2D{ x[i], y[i] } : Point2D{};
+}
+
+float ASGE::SpriteStore::rotation(SpriteHandle handle) const noexcept
+{
+  const auto i = denseIndex(handle);
+  return i < size() ? angle[i] : 0.0F;
+}